@@ -0,0 +1,14 @@
+#pragma once
+#include <cstdint>
+
+// Counts every heap allocation made through global operator new, from any
+// thread. The replacement operators live in AllocationCounter.cpp and are
+// linked into every program that reads the counter, which lets benchmarks
+// check that a loop does not allocate:
+//
+//     uint64_t before = allocations::count();
+//     ... loop ...
+//     assert(allocations::count() == before);
+namespace allocations {
+uint64_t count();
+}
@@ -9,7 +9,6 @@ public:
     Archer(const std::string& color);
     bool isValidMove(int fromX, int fromY, int toX, int toY, ChessBoard* board) const;
     bool canAttack(int fromX, int fromY, int toX, int toY, ChessBoard* board) const;
-    std::string getType() const { return "Archer"; }
 };
 
 #endif //CHESS3_ARCHER_H 
\ No newline at end of file
@@ -0,0 +1,187 @@
+#include "AttackMap.h"
+#include "GameState.h"
+#include "MoveValidator.h"
+#include "RangedAttacks.h"
+#include "SliderAttacks.h"
+
+namespace {
+const int KNIGHT_DX[8] = {2, 1, -1, -2, -2, -1, 1, 2};
+const int KNIGHT_DY[8] = {1, 2, 2, 1, -1, -2, -2, -1};
+}
+
+void AttackMap::build(const GameState& state) {
+    int size = state.board.getSize();
+    squares = size * size;
+    words = (squares + 63) / 64;
+    counts.assign(2 * static_cast<size_t>(squares), 0);
+    owner.assign(squares, -1);
+    owned.assign(words, 0);
+    attacks.assign(static_cast<size_t>(squares) * words, 0);
+    depends.assign(static_cast<size_t>(squares) * words, 0);
+    changed.assign(words, 0);
+    for (int sq = 0; sq < squares; ++sq) add(state, sq);
+}
+
+void AttackMap::clear() {
+    squares = 0;
+    words = 0;
+    counts.clear();
+    owner.clear();
+    owned.clear();
+    attacks.clear();
+    depends.clear();
+}
+
+void AttackMap::update(const GameState& state, const int* squareList, int count, int turnBefore) {
+    std::fill(changed.begin(), changed.end(), 0);
+    for (int i = 0; i < count; ++i) setBit(changed.data(), squareList[i]);
+    // A portal that opened or closed changes what can be reached through
+    // its entry and what a king can hop to from either end.
+    int size = state.board.getSize();
+    for (const Portal& portal : state.portals) {
+        if (portal.isAvailable(turnBefore) == portal.isAvailable(state.turn)) continue;
+        for (Position end : {portal.getEntry(), portal.getExit()}) {
+            if (state.board.isValidPosition(end.x, end.y)) setBit(changed.data(), end.y * size + end.x);
+        }
+    }
+
+    for (int word = 0; word < words; ++word) {
+        for (uint64_t bits = owned[word] | changed[word]; bits; bits &= bits - 1) {
+            int sq = word * 64 + __builtin_ctzll(bits);
+            bool hit = testBit(changed.data(), sq);
+            const uint64_t* on = &depends[static_cast<size_t>(sq) * words];
+            for (int w = 0; w < words && !hit; ++w) hit = (on[w] & changed[w]) != 0;
+            if (!hit) continue;
+            remove(sq);
+            add(state, sq);
+        }
+    }
+}
+
+void AttackMap::remove(int sq) {
+    if (owner[sq] < 0) return;
+    uint64_t* attacked = &attacks[static_cast<size_t>(sq) * words];
+    uint16_t* tally = &counts[owner[sq] * squares];
+    for (int w = 0; w < words; ++w) {
+        for (uint64_t bits = attacked[w]; bits; bits &= bits - 1) --tally[w * 64 + __builtin_ctzll(bits)];
+        attacked[w] = 0;
+        depends[static_cast<size_t>(sq) * words + w] = 0;
+    }
+    owner[sq] = -1;
+    owned[sq >> 6] &= ~(uint64_t(1) << (sq & 63));
+}
+
+void AttackMap::add(const GameState& state, int sq) {
+    const ChessBoard& board = state.board;
+    Piece* piece = board.pieceAt(board.squareToIndex(sq));
+    if (!piece) return;
+    uint64_t* attacked = &attacks[static_cast<size_t>(sq) * words];
+    compute(state, piece, sq, attacked, &depends[static_cast<size_t>(sq) * words]);
+    uint16_t* tally = &counts[piece->getColorId() * squares];
+    for (int w = 0; w < words; ++w) {
+        for (uint64_t bits = attacked[w]; bits; bits &= bits - 1) ++tally[w * 64 + __builtin_ctzll(bits)];
+    }
+    owner[sq] = static_cast<int8_t>(piece->getColorId());
+    setBit(owned.data(), sq);
+}
+
+void AttackMap::compute(const GameState& state, Piece* piece, int sq, uint64_t* attacked, uint64_t* dependsOn) {
+    computeMoves(state, piece, sq, attacked, dependsOn);
+    ranged::markShots(state.board, piece, sq, attacked, dependsOn);
+}
+
+void AttackMap::computeMoves(const GameState& state, Piece* piece, int sq, uint64_t* attacked, uint64_t* dependsOn) {
+    const ChessBoard& board = state.board;
+    int size = board.getSize();
+    int x = sq % size;
+    int y = sq / size;
+    const MoveRules& rules = piece->definition().rules;
+    setBit(dependsOn, sq);
+
+    if (rules.kernel == MoveKernel::PAWN) {
+        // validateMove only ever accepts these four squares for a pawn, and
+        // its answer reads no square beyond them and the two beside it.
+        MoveValidator validator(&board, &state.getPortalMap(), state.turn);
+        int direction = piece->getColorId() == WHITE ? 1 : -1;
+        const int candidates[6][2] = {{0, 1}, {0, 2}, {-1, 1}, {1, 1}, {-1, 0}, {1, 0}};
+        for (int i = 0; i < 6; ++i) {
+            int tx = x + candidates[i][0];
+            int ty = y + candidates[i][1] * direction;
+            if (!board.isValidPosition(tx, ty)) continue;
+            setBit(dependsOn, ty * size + tx);
+            if (i < 4 && validator.validateMove(piece, x, y, tx, ty, state.portals)) setBit(attacked, ty * size + tx);
+        }
+        return;
+    }
+
+    if (rules.kernel == MoveKernel::KING) {
+        for (int dy = -1; dy <= 1; ++dy) {
+            for (int dx = -1; dx <= 1; ++dx) {
+                if (board.isValidPosition(x + dx, y + dy)) setBit(attacked, (y + dy) * size + x + dx);
+            }
+        }
+        int color = piece->getColorId();
+        const PortalMap& portalMap = state.getPortalMap();
+        auto hop = [&](const PortalMap::Hop& h) {
+            const Portal& portal = state.portals[h.portal];
+            if (h.to >= 0 && portal.isAvailable(state.turn) && portal.isColorAllowed(color)) setBit(attacked, h.to);
+        };
+        for (const PortalMap::Hop* h = portalMap.begin(sq); h != portalMap.end(sq); ++h) hop(*h);
+        for (const PortalMap::Hop* h = portalMap.reverseBegin(sq); h != portalMap.reverseEnd(sq); ++h) hop(*h);
+        return;
+    }
+
+    if (withBehavior(rules.behavior, [&](const auto& kind) { kind.markMoves(board, piece, x, y, attacked, dependsOn); })) {
+        return;
+    }
+
+    // Everything else: the direct slides and leaps the steps do not give,
+    // then the BFS. The slides stop on their blocker and the BFS records
+    // every square it touched, so the attacked squares are also all they
+    // depend on, except for capture-only steps: those also depend on the
+    // empty squares they pass.
+    bool orthogonal = rules.extraOrthogonal;
+    bool diagonal = rules.extraDiagonal;
+    if (orthogonal || diagonal) {
+        if (!board.withBitboards([&](const auto& pos) {
+                if (orthogonal) {
+                    sliders::attacks(pos, sq, ORTHOGONAL, sliders::UNLIMITED, pos.occupied)
+                        .forEach([&](int to) { setBit(attacked, to); });
+                }
+                if (diagonal) {
+                    sliders::attacks(pos, sq, DIAGONAL, sliders::UNLIMITED, pos.occupied)
+                        .forEach([&](int to) { setBit(attacked, to); });
+                }
+            })) {
+            for (int dir = orthogonal ? 0 : 4; dir < (diagonal ? 8 : 4); ++dir) {
+                int step = direction::DX[dir] + direction::DY[dir] * board.getStride();
+                for (int index = board.toIndex(x, y) + step; !board.isOffboard(index); index += step) {
+                    setBit(attacked, board.toSquare(index));
+                    if (board.cellAt(index)) break;
+                }
+            }
+        }
+    }
+    if (rules.extraKnightLeap) {
+        for (int i = 0; i < 8; ++i) {
+            if (board.isValidPosition(x + KNIGHT_DX[i], y + KNIGHT_DY[i])) {
+                setBit(attacked, (y + KNIGHT_DY[i]) * size + x + KNIGHT_DX[i]);
+            }
+        }
+    }
+    reach.assign(words, 0);
+    search.markReachable(board, state.portals, state.getPortalMap(), state.turn, piece, sq, reach);
+    for (int w = 0; w < words; ++w) {
+        attacked[w] |= reach[w];
+        dependsOn[w] |= attacked[w];
+    }
+    if (rules.captureRange > 0 && piece->getColorId() < NO_COLOR) {
+        const ReachTable& steps = reach::table(piece->getTypeId(), size);
+        for (int side = 0; side < 2; ++side) {
+            for (const uint16_t* to = steps.captureBegin(piece->getColorId(), sq, side);
+                 to != steps.captureEnd(piece->getColorId(), sq, side); ++to) {
+                setBit(dependsOn, *to);
+            }
+        }
+    }
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "ReachSearch.h"
+
+class GameState;
+
+// How many pieces of each color attack every square, where a piece
+// attacks a square when validateMove would let it move there (so BFS
+// reach and portals count, and a BFS piece attacks its own square) or
+// when a ranged attack could hit it.
+//
+// Every piece's attacked squares are stored with the squares they depend
+// on: its whole search footprint for sliders and BFS movers, the few
+// squares around it for pawns, only its own square for kings. After a
+// move only the pieces whose dependencies include a changed square are
+// recomputed, so one update costs a handful of searches rather than one
+// per piece, and "is this square attacked" is a table lookup.
+class AttackMap {
+public:
+    // Recomputes every piece's attacks from scratch.
+    void build(const GameState& state);
+    // Brings the map up to date after the occupancy of `squares` changed
+    // and the game turn moved on from `turnBefore`.
+    void update(const GameState& state, const int* squares, int count, int turnBefore);
+    void clear();
+
+    bool empty() const { return counts.empty(); }
+    int count(int sq, int color) const { return counts[color * squares + sq]; }
+    bool isAttacked(int sq, int color) const { return counts[color * squares + sq] != 0; }
+
+private:
+    int squares = 0;
+    int words = 0;
+    std::vector<uint16_t> counts;   // [color * squares + sq]
+    std::vector<int8_t> owner;      // color of the piece stored at sq, -1 for none
+    std::vector<uint64_t> owned;    // squares with a stored piece
+    std::vector<uint64_t> attacks;  // [sq * words + w], squares the piece on sq attacks
+    std::vector<uint64_t> depends;  // [sq * words + w], squares those attacks depend on
+    std::vector<uint64_t> changed;
+    std::vector<uint64_t> reach;
+    ReachSearch search;
+
+    void remove(int sq);
+    void add(const GameState& state, int sq);
+    void compute(const GameState& state, Piece* piece, int sq, uint64_t* attacked, uint64_t* dependsOn);
+    void computeMoves(const GameState& state, Piece* piece, int sq, uint64_t* attacked, uint64_t* dependsOn);
+};
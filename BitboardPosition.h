@@ -0,0 +1,161 @@
+#pragma once
+#include <memory>
+#include <mutex>
+#include <variant>
+#include <vector>
+#include "BoardBitset.h"
+#include "Piece.h"
+
+// Largest board edge that still fits in the widest square set.
+constexpr int MAX_BITBOARD_SIZE = 32;
+
+namespace direction {
+constexpr int COUNT = 8;
+// N, S, E, W, NE, NW, SE, SW; the first four are orthogonal.
+constexpr int DX[COUNT] = {0, 0, 1, -1, 1, -1, 1, -1};
+constexpr int DY[COUNT] = {1, -1, 0, 0, 1, 1, -1, -1};
+
+inline bool isDiagonal(int dir) { return dir >= 4; }
+
+// Direction pointing from one square to another, or -1 when they do not
+// share a rank, file or diagonal.
+inline int between(int dx, int dy) {
+    if (dx == 0 && dy == 0) return -1;
+    if (dx != 0 && dy != 0 && dx != dy && dx != -dy) return -1;
+    int sx = (dx > 0) - (dx < 0);
+    int sy = (dy > 0) - (dy < 0);
+    for (int dir = 0; dir < COUNT; ++dir) {
+        if (DX[dir] == sx && DY[dir] == sy) return dir;
+    }
+    return -1;
+}
+}
+
+// Per-size masks shared by every position of that size: the playable
+// area, edge files and the ray from each square in each direction.
+// Squares are numbered y * size + x.
+template <typename Set>
+struct BitboardGeometry {
+    int size;
+    Set boardMask;
+    Set notFirstFile;
+    Set notLastFile;
+    std::vector<Set> rays;
+
+    explicit BitboardGeometry(int n) : size(n), rays(static_cast<size_t>(n) * n * direction::COUNT) {
+        for (int y = 0; y < n; ++y) {
+            for (int x = 0; x < n; ++x) {
+                int sq = y * n + x;
+                boardMask.set(sq);
+                if (x != 0) notFirstFile.set(sq);
+                if (x != n - 1) notLastFile.set(sq);
+                for (int dir = 0; dir < direction::COUNT; ++dir) {
+                    int rx = x + direction::DX[dir];
+                    int ry = y + direction::DY[dir];
+                    while (rx >= 0 && rx < n && ry >= 0 && ry < n) {
+                        rays[sq * direction::COUNT + dir].set(ry * n + rx);
+                        rx += direction::DX[dir];
+                        ry += direction::DY[dir];
+                    }
+                }
+            }
+        }
+    }
+
+    // Squares from sq towards the edge, not including sq itself.
+    const Set& ray(int sq, int dir) const { return rays[sq * direction::COUNT + dir]; }
+
+    // The ray cut off after `range` steps.
+    Set clippedRay(int sq, int dir, int range) const {
+        int x = sq % size + direction::DX[dir] * range;
+        int y = sq / size + direction::DY[dir] * range;
+        if (x < 0 || x >= size || y < 0 || y >= size) return ray(sq, dir);
+        return ray(sq, dir) & ~ray(y * size + x, dir);
+    }
+
+    Set between(int from, int to) const {
+        int dir = direction::between(to % size - from % size, to / size - from / size);
+        if (dir < 0) return Set();
+        Set path = ray(from, dir) & ~ray(to, dir);
+        path.reset(to);
+        return path;
+    }
+
+    // Moves every square in s one step in a direction, dropping squares
+    // that would leave the board.
+    Set shift(const Set& s, int dir) const {
+        switch (dir) {
+            case 0: return (s << size) & boardMask;
+            case 1: return s >> size;
+            case 2: return (s & notLastFile) << 1;
+            case 3: return (s & notFirstFile) >> 1;
+            case 4: return ((s & notLastFile) << (size + 1)) & boardMask;
+            case 5: return ((s & notFirstFile) << (size - 1)) & boardMask;
+            case 6: return (s & notLastFile) >> (size - 1);
+            default: return (s & notFirstFile) >> (size + 1);
+        }
+    }
+
+    static const BitboardGeometry& forSize(int n) {
+        static std::unique_ptr<BitboardGeometry> cache[MAX_BITBOARD_SIZE + 1];
+        static std::once_flag built[MAX_BITBOARD_SIZE + 1];
+        std::call_once(built[n], [n] { cache[n] = std::make_unique<BitboardGeometry>(n); });
+        return *cache[n];
+    }
+};
+
+// Occupancy masks per color and per piece type id for one board, kept in
+// sync with the mailbox by ChessBoard.
+template <typename Set>
+struct BitboardPosition {
+    using SetType = Set;
+
+    const BitboardGeometry<Set>* geometry;
+    Set byColor[2];
+    Set byType[Piece::MAX_TYPES];
+    Set occupied;
+
+    explicit BitboardPosition(int boardSize) : geometry(&BitboardGeometry<Set>::forSize(boardSize)) {}
+
+    int size() const { return geometry->size; }
+
+    void add(int sq, const Piece* piece) {
+        occupied.set(sq);
+        if (piece->getColorId() < NO_COLOR) byColor[piece->getColorId()].set(sq);
+        if (piece->getTypeId() < Piece::MAX_TYPES) byType[piece->getTypeId()].set(sq);
+    }
+
+    void remove(int sq, const Piece* piece) {
+        occupied.reset(sq);
+        if (piece->getColorId() < NO_COLOR) byColor[piece->getColorId()].reset(sq);
+        if (piece->getTypeId() < Piece::MAX_TYPES) byType[piece->getTypeId()].reset(sq);
+    }
+
+    const Set& pieces(int color) const { return byColor[color]; }
+    Set pieces(int color, int typeId) const { return byColor[color] & byType[typeId]; }
+
+    bool isPathClear(int from, int to) const { return (geometry->between(from, to) & occupied).none(); }
+};
+
+using Bitboard64 = BoardBitset<64>;
+using Bitboard128 = BoardBitset<128>;
+using Bitboard256 = BoardBitset<256>;
+using Bitboard1024 = BoardBitset<1024>;
+
+// Occupancy for a board of any supported size: the narrowest square set
+// that holds board_size^2 bits, or nothing for boards beyond
+// MAX_BITBOARD_SIZE (those fall back to mailbox scans).
+using OccupancySets = std::variant<std::monostate,
+                                   BitboardPosition<Bitboard64>,
+                                   BitboardPosition<Bitboard128>,
+                                   BitboardPosition<Bitboard256>,
+                                   BitboardPosition<Bitboard1024>>;
+
+inline OccupancySets makeOccupancySets(int boardSize) {
+    int squares = boardSize * boardSize;
+    if (boardSize <= 0 || boardSize > MAX_BITBOARD_SIZE) return std::monostate();
+    if (squares <= 64) return BitboardPosition<Bitboard64>(boardSize);
+    if (squares <= 128) return BitboardPosition<Bitboard128>(boardSize);
+    if (squares <= 256) return BitboardPosition<Bitboard256>(boardSize);
+    return BitboardPosition<Bitboard1024>(boardSize);
+}
@@ -0,0 +1,125 @@
+#pragma once
+#include <cstdint>
+
+// Fixed-width square set made of 64-bit words. Every operation is a loop
+// over a compile-time number of words, which the compiler unrolls and
+// vectorizes; BoardBitset<64> compiles down to plain uint64_t arithmetic.
+template <int Bits>
+struct BoardBitset {
+    static constexpr int BITS = Bits;
+    static constexpr int WORDS = (Bits + 63) / 64;
+
+    uint64_t words[WORDS] = {};
+
+    static BoardBitset square(int sq) {
+        BoardBitset b;
+        b.set(sq);
+        return b;
+    }
+
+    bool test(int sq) const { return (words[sq >> 6] >> (sq & 63)) & 1; }
+    void set(int sq) { words[sq >> 6] |= uint64_t(1) << (sq & 63); }
+    void reset(int sq) { words[sq >> 6] &= ~(uint64_t(1) << (sq & 63)); }
+
+    bool any() const {
+        uint64_t acc = 0;
+        for (int i = 0; i < WORDS; ++i) acc |= words[i];
+        return acc != 0;
+    }
+    bool none() const { return !any(); }
+
+    int count() const {
+        int total = 0;
+        for (int i = 0; i < WORDS; ++i) total += __builtin_popcountll(words[i]);
+        return total;
+    }
+
+    // Index of the lowest set bit; the set must not be empty.
+    int lsb() const {
+        for (int i = 0; i < WORDS; ++i) {
+            if (words[i]) return i * 64 + __builtin_ctzll(words[i]);
+        }
+        return -1;
+    }
+
+    // Index of the highest set bit; the set must not be empty.
+    int msb() const {
+        for (int i = WORDS - 1; i >= 0; --i) {
+            if (words[i]) return i * 64 + 63 - __builtin_clzll(words[i]);
+        }
+        return -1;
+    }
+
+    int popLsb() {
+        for (int i = 0; i < WORDS; ++i) {
+            if (words[i]) {
+                int sq = i * 64 + __builtin_ctzll(words[i]);
+                words[i] &= words[i] - 1;
+                return sq;
+            }
+        }
+        return -1;
+    }
+
+    // Calls fn(sq) for every set bit in ascending order.
+    template <typename Fn>
+    void forEach(Fn&& fn) const {
+        for (int i = 0; i < WORDS; ++i) {
+            for (uint64_t w = words[i]; w; w &= w - 1) fn(i * 64 + __builtin_ctzll(w));
+        }
+    }
+
+    BoardBitset& operator&=(const BoardBitset& o) {
+        for (int i = 0; i < WORDS; ++i) words[i] &= o.words[i];
+        return *this;
+    }
+    BoardBitset& operator|=(const BoardBitset& o) {
+        for (int i = 0; i < WORDS; ++i) words[i] |= o.words[i];
+        return *this;
+    }
+    BoardBitset& operator^=(const BoardBitset& o) {
+        for (int i = 0; i < WORDS; ++i) words[i] ^= o.words[i];
+        return *this;
+    }
+    BoardBitset operator~() const {
+        BoardBitset r;
+        for (int i = 0; i < WORDS; ++i) r.words[i] = ~words[i];
+        return r;
+    }
+    friend BoardBitset operator&(BoardBitset a, const BoardBitset& b) { return a &= b; }
+    friend BoardBitset operator|(BoardBitset a, const BoardBitset& b) { return a |= b; }
+    friend BoardBitset operator^(BoardBitset a, const BoardBitset& b) { return a ^= b; }
+
+    bool operator==(const BoardBitset& o) const {
+        uint64_t diff = 0;
+        for (int i = 0; i < WORDS; ++i) diff |= words[i] ^ o.words[i];
+        return diff == 0;
+    }
+    bool operator!=(const BoardBitset& o) const { return !(*this == o); }
+
+    BoardBitset operator<<(int n) const {
+        BoardBitset r;
+        if (n >= Bits) return r;
+        int wordShift = n >> 6;
+        int bitShift = n & 63;
+        for (int i = WORDS - 1; i >= wordShift; --i) {
+            uint64_t v = words[i - wordShift] << bitShift;
+            if (bitShift && i - wordShift - 1 >= 0) v |= words[i - wordShift - 1] >> (64 - bitShift);
+            r.words[i] = v;
+        }
+        return r;
+    }
+
+    BoardBitset operator>>(int n) const {
+        BoardBitset r;
+        if (n >= Bits) return r;
+        int wordShift = n >> 6;
+        int bitShift = n & 63;
+        for (int i = 0; i + wordShift < WORDS; ++i) {
+            uint64_t v = words[i + wordShift] >> bitShift;
+            if (bitShift && i + wordShift + 1 < WORDS) v |= words[i + wordShift + 1] << (64 - bitShift);
+            r.words[i] = v;
+        }
+        return r;
+    }
+};
@@ -1,34 +1,74 @@
 #include "BoardPrinter.h"
+#include <iomanip>
 #include <iostream>
-#include <unordered_map>
+#include <vector>
 
-void BoardPrinter::print(const ChessBoard& board) const {
-    std::unordered_map<std::string, std::string> whiteSymbols = {
-        {"King", "♔"}, {"Queen", "♕"}, {"Rook", "♖"},
-        {"Bishop", "♗"}, {"Knight", "♘"}, {"Pawn", "♙"}
-    };
-    std::unordered_map<std::string, std::string> blackSymbols = {
-        {"King", "♚"}, {"Queen", "♛"}, {"Rook", "♜"},
-        {"Bishop", "♝"}, {"Knight", "♞"}, {"Pawn", "♟"}
-    };
+namespace {
+// Symbols indexed by [colorId][typeId]; types without a glyph print the
+// first letter of their name.
+struct SymbolTable {
+    std::vector<const char*> symbols[2];
+
+    SymbolTable() {
+        const char* const names[] = {"King", "Queen", "Rook", "Bishop", "Knight", "Pawn"};
+        const char* const white[] = {"♔", "♕", "♖", "♗", "♘", "♙"};
+        const char* const black[] = {"♚", "♛", "♜", "♝", "♞", "♟"};
+        for (int i = 0; i < 6; ++i) {
+            int typeId = Piece::typeIdOf(names[i]);
+            for (auto& table : symbols) {
+                if (typeId >= static_cast<int>(table.size())) table.resize(typeId + 1, nullptr);
+            }
+            symbols[WHITE][typeId] = white[i];
+            symbols[BLACK][typeId] = black[i];
+        }
+    }
+
+    const char* find(int typeId, int colorId) const {
+        if (colorId != WHITE && colorId != BLACK) return nullptr;
+        const auto& table = symbols[colorId];
+        return typeId < static_cast<int>(table.size()) ? table[typeId] : nullptr;
+    }
+};
+
+const SymbolTable SYMBOLS;
+}
 
+void BoardPrinter::print(const ChessBoard& board) const {
+    int size = board.getSize();
     std::cout << "   ";
-    for (int x = 0; x < 8; ++x) std::cout << " " << x;
+    for (int x = 0; x < size; ++x) std::cout << std::setw(2) << x;
     std::cout << "\n";
-    for (int y = 7; y >= 0; --y) {
-        std::cout << " " << y << " ";
-        for (int x = 0; x < 8; ++x) {
+    for (int y = size - 1; y >= 0; --y) {
+        std::cout << std::setw(2) << y << " ";
+        for (int x = 0; x < size; ++x) {
             Piece* p = board.getPieceAt(x, y);
-            std::string symbol = ".";
-            if (p) {
-                std::string t = p->getType();
-                std::string color = p->getColor();
-                if (color == "white" && whiteSymbols.count(t)) symbol = whiteSymbols[t];
-                else if (color == "black" && blackSymbols.count(t)) symbol = blackSymbols[t];
-                else symbol = t.substr(0, 1);
+            std::cout << " ";
+            if (!p) {
+                std::cout << ".";
+            } else if (const char* symbol = SYMBOLS.find(p->getTypeId(), p->getColorId())) {
+                std::cout << symbol;
+            } else {
+                std::cout << p->getType().substr(0, 1);
             }
-            std::cout << " " << symbol;
         }
         std::cout << "\n";
     }
-}
\ No newline at end of file
+}
+
+void BoardPrinter::printAttacks(const ChessBoard& board, const AttackMap& attacks, int color) const {
+    int size = board.getSize();
+    std::cout << "   ";
+    for (int x = 0; x < size; ++x) std::cout << std::setw(2) << x;
+    std::cout << "\n";
+    for (int y = size - 1; y >= 0; --y) {
+        std::cout << std::setw(2) << y << " ";
+        for (int x = 0; x < size; ++x) {
+            int count = attacks.count(y * size + x, color);
+            std::cout << " ";
+            if (count == 0) std::cout << ".";
+            else if (count < 10) std::cout << count;
+            else std::cout << "+";
+        }
+        std::cout << "\n";
+    }
+}
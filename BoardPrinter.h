@@ -1,7 +1,10 @@
 #pragma once
+#include "AttackMap.h"
 #include "ChessBoard.h"
 
 class BoardPrinter {
 public:
     void print(const ChessBoard& board) const;
+    // How many pieces of `color` attack each square, in the same layout.
+    void printAttacks(const ChessBoard& board, const AttackMap& attacks, int color) const;
 }; 
\ No newline at end of file
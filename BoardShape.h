@@ -0,0 +1,49 @@
+#pragma once
+
+// Cells of sentinel border around the playable area of ChessBoard's
+// mailbox.
+constexpr int MAILBOX_BORDER = 2;
+
+// Board dimensions as the hot kernels (reach search, move generation) see
+// them. BoardShape<N> has the edge as a compile-time constant, so square
+// and mailbox conversions, bounds tests and loop limits fold into
+// constants; BoardShape<0> carries the edge at run time and serves every
+// other size through the same code. Squares are numbered y * size + x.
+template <int N>
+struct BoardShape {
+    static constexpr bool FIXED = N > 0;
+    // Sizes of per-square scratch a kernel can keep on the stack; 1 for
+    // the runtime shape, which needs buffers sized on use instead.
+    static constexpr int STACK_SQUARES = FIXED ? N * N : 1;
+    static constexpr int STACK_WORDS = (STACK_SQUARES + 63) / 64;
+
+    int runtimeSize = N;
+
+    constexpr int size() const { return FIXED ? N : runtimeSize; }
+    constexpr int squares() const { return size() * size(); }
+    constexpr int words() const { return (squares() + 63) / 64; }
+    constexpr int stride() const { return size() + 2 * MAILBOX_BORDER; }
+
+    constexpr bool contains(int x, int y) const {
+        return static_cast<unsigned>(x) < static_cast<unsigned>(size()) &&
+               static_cast<unsigned>(y) < static_cast<unsigned>(size());
+    }
+    constexpr int toSquare(int x, int y) const { return y * size() + x; }
+    constexpr int toIndex(int x, int y) const { return (y + MAILBOX_BORDER) * stride() + x + MAILBOX_BORDER; }
+    constexpr int squareToIndex(int sq) const { return toIndex(sq % size(), sq / size()); }
+};
+
+using RuntimeShape = BoardShape<0>;
+
+// Calls fn(shape) with the specialised BoardShape for the common edges
+// (8, 10, 12 and 16) and a RuntimeShape for any other.
+template <typename Fn>
+decltype(auto) withBoardShape(int size, Fn&& fn) {
+    switch (size) {
+        case 8: return fn(BoardShape<8>());
+        case 10: return fn(BoardShape<10>());
+        case 12: return fn(BoardShape<12>());
+        case 16: return fn(BoardShape<16>());
+        default: return fn(RuntimeShape{size});
+    }
+}
@@ -0,0 +1,145 @@
+#include "CheckInfo.h"
+#include "MoveValidator.h"
+#include "RangedAttacks.h"
+#include <cstdlib>
+
+namespace {
+const int KING_TYPE = Piece::typeIdOf("King");
+
+int sign(int v) { return (v > 0) - (v < 0); }
+}
+
+void CheckInfo::compute(const GameState& state, int color) {
+    this->state = &state;
+    this->color = color;
+    trialReady = false;
+    checkers = 0;
+    attackers.clear();
+    depends.clear();
+
+    const ChessBoard& board = state.board;
+    int size = board.getSize();
+    words = (size * size + 63) / 64;
+    evasionMask.assign(words, ~uint64_t(0));
+    pinMask.assign(words, 0);
+
+    int kingX, kingY;
+    if (!board.findPiece(KING_TYPE, color, kingX, kingY)) {
+        king = -1;
+        return;
+    }
+    king = kingY * size + kingX;
+
+    int turn = state.turn + 1;
+    MoveValidator validator(&board, &state.getPortalMap(), turn);
+    board.forEachPiece(opponentOf(color), [&](Piece* piece, int x, int y) {
+        int from = y * size + x;
+        bool checks = validator.validateMove(piece, x, y, kingX, kingY, state.portals) ||
+                      ranged::covers(board, piece, x, y, kingX, kingY);
+        footprint.assign(words, 0);
+        // Hand-written rules report every square their answers read.
+        bool custom = withBehavior(piece->definition().rules.behavior, [&](const auto& kind) {
+            kind.markMoves(board, piece, x, y, footprint.data(), footprint.data());
+        });
+        if (custom || !MoveValidator::readsBoard(piece->getTypeId())) {
+            // Otherwise only a capture can change what a pawn or king attacks.
+            setBit(footprint.data(), from);
+        } else if (checks) {
+            // The check holds while its route stays empty, whichever rule
+            // gave it: a slide, a route through the BFS, or none for leaps.
+            setBit(footprint.data(), from);
+            search.route(board, state.portals, state.getPortalMap(), turn, piece, from, king, footprint);
+        } else {
+            search.markReachable(board, state.portals, state.getPortalMap(), turn, piece, from, footprint);
+        }
+        // Direct slides are not limited by the configured range.
+        int dx = kingX - x;
+        int dy = kingY - y;
+        bool aligned = (dx == 0) != (dy == 0) || (dx != 0 && std::abs(dx) == std::abs(dy));
+        if (aligned && MoveValidator::readsBoard(piece->getTypeId())) {
+            for (int cx = x + sign(dx), cy = y + sign(dy); cx != kingX || cy != kingY; cx += sign(dx), cy += sign(dy)) {
+                setBit(footprint.data(), cy * size + cx);
+            }
+        }
+        if (piece->definition().rules.shotRange > 0) {
+            shots.assign(words, 0);
+            ranged::markShots(board, piece, from, shots.data(), footprint.data());
+        }
+
+        attackers.push_back({from, checks});
+        depends.insert(depends.end(), footprint.begin(), footprint.end());
+        for (int w = 0; w < words; ++w) {
+            if (checks) evasionMask[w] &= footprint[w];
+            else pinMask[w] |= footprint[w];
+        }
+        if (checks) ++checkers;
+    });
+}
+
+bool CheckInfo::isLegal(const Move& move) {
+    if (king < 0) return true;
+    if (mustPlayOut(move)) return playOut(move);
+
+    int size = state->board.getSize();
+    int changed[3] = {move.from, move.to, move.to};
+    if (move.is(MOVE_EN_PASSANT)) changed[2] = (move.from / size) * size + move.to % size;
+    auto touches = [&](const uint64_t* mask) {
+        return testBit(mask, changed[0]) || testBit(mask, changed[1]) || testBit(mask, changed[2]);
+    };
+
+    if (checkers && !touches(evasionMask.data())) return false;
+    if (!checkers && !touches(pinMask.data())) return true;
+
+    affected.clear();
+    for (int i = 0; i < static_cast<int>(attackers.size()); ++i) {
+        if (touches(&depends[static_cast<size_t>(i) * words])) affected.push_back(i);
+        else if (attackers[i].checks) return false;
+    }
+    return affected.empty() || recheck(move);
+}
+
+bool CheckInfo::mustPlayOut(const Move& move) const {
+    return move.from == king || move.is(MOVE_PORTAL) || move.is(MOVE_RANGED) ||
+           (move.is(MOVE_PROMOTION) && move.promotion == KING_TYPE);
+}
+
+GameState& CheckInfo::trialState() {
+    if (!trial) trial = std::make_unique<GameState>(*state);
+    else if (!trialReady) *trial = *state;
+    if (!trialReady) trial->trackAttacks(false);
+    trialReady = true;
+    return *trial;
+}
+
+bool CheckInfo::playOut(const Move& move) {
+    GameState& next = trialState();
+    next.makeMove(move);
+    bool safe = !next.isInCheck(color);
+    next.unmakeMove();
+    return safe;
+}
+
+bool CheckInfo::recheck(const Move& move) {
+    GameState& next = trialState();
+    next.makeMove(move);
+    const ChessBoard& board = next.board;
+    int size = board.getSize();
+    MoveValidator validator(&board, &next.getPortalMap(), next.turn);
+    bool safe = true;
+    // Pieces that gave check are the likeliest to still give it.
+    for (int pass = 0; pass < 2 && safe; ++pass) {
+        for (int i : affected) {
+            if (attackers[i].checks != (pass == 0)) continue;
+            int sq = attackers[i].square;
+            Piece* piece = board.pieceAt(board.squareToIndex(sq));
+            if (piece && piece->getColorId() != color &&
+                (validator.validateMove(piece, sq % size, sq / size, king % size, king / size, next.portals) ||
+                 ranged::covers(board, piece, sq % size, sq / size, king % size, king / size))) {
+                safe = false;
+                break;
+            }
+        }
+    }
+    next.unmakeMove();
+    return safe;
+}
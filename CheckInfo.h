@@ -0,0 +1,69 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "GameState.h"
+#include "Move.h"
+#include "ReachSearch.h"
+
+// Legality of one side's moves in a position, worked out once so that
+// each move is judged by a few mask tests instead of being played out.
+//
+// Attacks here are validateMove's, BFS and portals included, plus ranged
+// attacks, so the classic pin rays generalise: for every enemy piece we
+// keep the squares whose occupancy its answer to "do you reach the king?"
+// depends on (its whole search footprint, the lines of sight of its shots
+// and the line to the king). A move that changes
+// none of a piece's squares cannot change that answer. So
+//   - a checker whose squares the move misses still gives check, and the
+//     intersection of all checkers' squares is the evasion mask;
+//   - a non-checker can only start giving check when the move empties one
+//     of its squares, and their union is the pin mask.
+// Only moves that fall inside a mask are played out, on a private copy of
+// the position, and only the enemy pieces they touch are asked again.
+// King moves, portal moves and ranged attacks are always played out.
+//
+// Everything is judged after the turn tick a move causes, as GameState
+// does. One instance must not be used by two threads at once.
+class CheckInfo {
+public:
+    // Examines `state` for `color` to move; the state must outlive the
+    // isLegal calls that follow.
+    void compute(const GameState& state, int color);
+
+    // Whether `move` leaves the mover's king unattacked.
+    bool isLegal(const Move& move);
+
+    // Whether the king is attacked once the turn has ticked; false when
+    // the side has no king.
+    bool hasCheckers() const { return checkers > 0; }
+
+private:
+    struct Attacker {
+        int square;
+        bool checks;
+    };
+
+    const GameState* state = nullptr;
+    int color = 0;
+    int king = -1;
+    int words = 0;
+    int checkers = 0;
+    std::vector<Attacker> attackers;
+    std::vector<uint64_t> depends;      // [attacker * words + w]
+    std::vector<uint64_t> evasionMask;  // squares every checker depends on
+    std::vector<uint64_t> pinMask;      // squares some non-checker depends on
+    std::vector<int> affected;
+    std::vector<uint64_t> footprint;
+    std::vector<uint64_t> shots;
+    ReachSearch search;
+    std::unique_ptr<GameState> trial;
+    bool trialReady = false;
+
+    GameState& trialState();
+    bool mustPlayOut(const Move& move) const;
+    // Plays the move on the copy and asks every enemy piece again.
+    bool playOut(const Move& move);
+    // Plays the move on the copy and asks only the affected pieces again.
+    bool recheck(const Move& move);
+};
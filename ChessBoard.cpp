@@ -1,43 +1,166 @@
 #include "ChessBoard.h"
-#include <sstream>
+#include "Zobrist.h"
 
-ChessBoard::ChessBoard(int boardSize) : size(boardSize) {}
-
-std::string ChessBoard::posToKey(int x, int y) const {
-    return std::to_string(x) + "," + std::to_string(y);
+namespace {
+// A type id no type is ever interned under, so the sentinel defines
+// nothing while statics are still being initialized.
+const int OFFBOARD_TYPE = 0xFFFF;
+Piece offboardSentinel(OFFBOARD_TYPE, NO_COLOR);
 }
 
-bool ChessBoard::isValidPosition(int x, int y) const {
-    return x >= 0 && x < size && y >= 0 && y < size;
+Piece* const ChessBoard::OFFBOARD = &offboardSentinel;
+
+ChessBoard::ChessBoard(int boardSize)
+    : size(boardSize), stride(boardSize + 2 * BORDER), bits(makeOccupancySets(boardSize)),
+      nextInList(static_cast<size_t>(boardSize) * boardSize, -1),
+      prevInList(static_cast<size_t>(boardSize) * boardSize, -1) {
+    for (int color = 0; color < 2; ++color) {
+        for (int type = 0; type < Piece::MAX_TYPES; ++type) {
+            listHead[color][type] = -1;
+            listCount[color][type] = 0;
+        }
+    }
+    cells.assign(static_cast<size_t>(stride) * stride, OFFBOARD);
+    for (int y = 0; y < size; ++y) {
+        for (int x = 0; x < size; ++x) {
+            cells[toIndex(x, y)] = nullptr;
+        }
+    }
 }
 
 Piece* ChessBoard::getPieceAt(int x, int y) const {
-    std::string key = posToKey(x, y);
-    auto it = board.find(key);
-    return (it != board.end()) ? it->second : nullptr;
+    if (!isValidPosition(x, y)) return nullptr;
+    return cells[toIndex(x, y)];
 }
 
 void ChessBoard::placePiece(int x, int y, Piece* piece) {
     if (!isValidPosition(x, y)) return;
-    board[posToKey(x, y)] = piece;
+    placePieceAt(toIndex(x, y), piece);
 }
 
 void ChessBoard::removePiece(int x, int y) {
-    board.erase(posToKey(x, y));
+    if (!isValidPosition(x, y)) return;
+    removePieceAt(toIndex(x, y));
 }
 
 void ChessBoard::movePiece(int fromX, int fromY, int toX, int toY) {
-    Piece* piece = getPieceAt(fromX, fromY);
-    if (piece && isValidPosition(toX, toY)) {
-        removePiece(fromX, fromY);
-        placePiece(toX, toY, piece);
-    }
+    if (!isValidPosition(fromX, fromY) || !isValidPosition(toX, toY)) return;
+    movePieceAt(toIndex(fromX, fromY), toIndex(toX, toY));
 }
 
 std::vector<Piece*> ChessBoard::getAllPieces() const {
     std::vector<Piece*> pieces;
-    for (const auto& [key, piece] : board) {
-        if (piece) pieces.push_back(piece);
+    if (withBitboards([&](const auto& pos) {
+            pieces.reserve(pos.occupied.count());
+            pos.occupied.forEach([&](int sq) { pieces.push_back(cells[squareToIndex(sq)]); });
+        })) {
+        return pieces;
+    }
+    for (int index = firstIndex(); index <= lastIndex(); ++index) {
+        Piece* piece = cells[index];
+        if (piece && piece != OFFBOARD) pieces.push_back(piece);
     }
     return pieces;
-}
\ No newline at end of file
+}
+
+bool ChessBoard::findPiece(int typeId, int colorId, int& x, int& y) const {
+    if (colorId < NO_COLOR && typeId >= 0 && typeId < Piece::MAX_TYPES) {
+        // The list is unordered; "first" is the lowest square, as a scan
+        // would find it.
+        int first = -1;
+        for (int sq = listHead[colorId][typeId]; sq >= 0; sq = nextInList[sq]) {
+            if (first < 0 || sq < first) first = sq;
+        }
+        if (first < 0) return false;
+        x = first % size;
+        y = first / size;
+        return true;
+    }
+    for (int index = firstIndex(); index <= lastIndex(); ++index) {
+        Piece* piece = pieceAt(index);
+        if (piece && piece->getTypeId() == typeId && piece->getColorId() == colorId) {
+            x = indexToX(index);
+            y = indexToY(index);
+            return true;
+        }
+    }
+    return false;
+}
+
+int ChessBoard::pieceCount(int typeId, int colorId) const {
+    if (colorId < NO_COLOR && typeId >= 0 && typeId < Piece::MAX_TYPES) return listCount[colorId][typeId];
+    int count = 0;
+    forEachPiece(colorId, [&](Piece* piece, int, int) {
+        if (piece->getTypeId() == typeId) ++count;
+    });
+    return count;
+}
+
+void ChessBoard::link(int sq, const Piece* piece) {
+    int color = piece->getColorId();
+    if (color < NO_COLOR && piece->hasAbility(ABILITY_ROYAL)) ++royals[color];
+    if (!isListed(piece)) return;
+    int& head = listHead[color][piece->getTypeId()];
+    nextInList[sq] = head;
+    prevInList[sq] = -1;
+    if (head >= 0) prevInList[head] = sq;
+    head = sq;
+    ++listCount[color][piece->getTypeId()];
+}
+
+void ChessBoard::unlink(int sq, const Piece* piece) {
+    int color = piece->getColorId();
+    if (color < NO_COLOR && piece->hasAbility(ABILITY_ROYAL)) --royals[color];
+    if (!isListed(piece)) return;
+    int next = nextInList[sq];
+    int prev = prevInList[sq];
+    if (prev >= 0) nextInList[prev] = next;
+    else listHead[color][piece->getTypeId()] = next;
+    if (next >= 0) prevInList[next] = prev;
+    --listCount[color][piece->getTypeId()];
+}
+
+void ChessBoard::placePieceAt(int index, Piece* piece) {
+    if (isOffboard(index)) return;
+    Piece* previous = cells[index];
+    int sq = toSquare(index);
+    std::visit([&](auto& pos) {
+        if constexpr (!std::is_same_v<std::decay_t<decltype(pos)>, std::monostate>) {
+            if (previous) pos.remove(sq, previous);
+            if (piece) pos.add(sq, piece);
+        }
+    }, bits);
+    if (previous) {
+        hash ^= zobrist::pieceKey(previous->getTypeId(), previous->getColorId(), sq);
+        unlink(sq, previous);
+    }
+    if (piece) {
+        hash ^= zobrist::pieceKey(piece->getTypeId(), piece->getColorId(), sq);
+        link(sq, piece);
+    }
+    cells[index] = piece;
+}
+
+void ChessBoard::removePieceAt(int index) {
+    if (isOffboard(index)) return;
+    Piece* previous = cells[index];
+    if (!previous) return;
+    int sq = toSquare(index);
+    std::visit([&](auto& pos) {
+        if constexpr (!std::is_same_v<std::decay_t<decltype(pos)>, std::monostate>) {
+            pos.remove(sq, previous);
+        }
+    }, bits);
+    hash ^= zobrist::pieceKey(previous->getTypeId(), previous->getColorId(), sq);
+    unlink(sq, previous);
+    cells[index] = nullptr;
+}
+
+void ChessBoard::movePieceAt(int from, int to) {
+    Piece* piece = pieceAt(from);
+    if (piece && !isOffboard(to)) {
+        removePieceAt(to);
+        removePieceAt(from);
+        placePieceAt(to, piece);
+    }
+}
@@ -1,22 +1,153 @@
 #pragma once
-#include <unordered_map>
+#include <cstdint>
 #include <string>
 #include "Piece.h"
+#include "BitboardPosition.h"
+#include "BoardShape.h"
+#include <type_traits>
 #include <vector>
 
+// The board is a flat mailbox: one Piece* per cell, with a sentinel border
+// of BORDER cells around the playable area so that ray walks and leaper
+// offsets from edge squares land on OFFBOARD instead of wrapping around.
+// Index-based accessors take mailbox indices from toIndex() and never
+// allocate; the (x, y) API is kept on top of them.
+//
+// The mailbox is mirrored by a BitboardPosition whose square-set width is
+// picked from the board size (see makeOccupancySets), so that set
+// questions (occupancy, king square, all pieces of a color) are mask
+// operations rather than square scans on every supported size.
+//
+// Every piece of a tracked type and color is also on a piece list: the
+// squares of one (color, type) linked through per-square next/previous
+// entries, with a count per list and a count of royal pieces per color,
+// so locating the king or counting material does not scan the board.
+//
+// Kernels that walk the board take its BoardShape from withShape(), which
+// gives the common sizes a compile-time edge.
 class ChessBoard {
 private:
-    std::unordered_map<std::string, Piece*> board;
+    static constexpr int BORDER = MAILBOX_BORDER;
+
+    std::vector<Piece*> cells;
     int size;
+    int stride;
+    OccupancySets bits;
+    uint64_t hash = 0;
+
+    std::vector<int> nextInList;  // [sq], -1 at the end of a list
+    std::vector<int> prevInList;  // [sq], -1 at the head
+    int listHead[2][Piece::MAX_TYPES];
+    int listCount[2][Piece::MAX_TYPES];
+    int royals[2] = {0, 0};
 
-    std::string posToKey(int x, int y) const;
+    static bool isListed(const Piece* piece) {
+        return piece->getColorId() < NO_COLOR && piece->getTypeId() < Piece::MAX_TYPES;
+    }
+    void link(int sq, const Piece* piece);
+    void unlink(int sq, const Piece* piece);
 
 public:
+    static Piece* const OFFBOARD;
+
     ChessBoard(int boardSize);
-    bool isValidPosition(int x, int y) const;
+    bool isValidPosition(int x, int y) const {
+        return static_cast<unsigned>(x) < static_cast<unsigned>(size) && static_cast<unsigned>(y) < static_cast<unsigned>(size);
+    }
     Piece* getPieceAt(int x, int y) const;
     void placePiece(int x, int y, Piece* piece);
     void removePiece(int x, int y);
     void movePiece(int fromX, int fromY, int toX, int toY);
     std::vector<Piece*> getAllPieces() const;
-};
\ No newline at end of file
+
+    int getSize() const { return size; }
+    int getStride() const { return stride; }
+    int toIndex(int x, int y) const { return (y + BORDER) * stride + (x + BORDER); }
+    int indexToX(int index) const { return index % stride - BORDER; }
+    int indexToY(int index) const { return index / stride - BORDER; }
+    int firstIndex() const { return toIndex(0, 0); }
+    int lastIndex() const { return toIndex(size - 1, size - 1); }
+
+    // Raw cell access: returns nullptr for an empty square and OFFBOARD for
+    // a border cell.
+    Piece* cellAt(int index) const { return cells[index]; }
+    bool isOffboard(int index) const { return cells[index] == OFFBOARD; }
+    Piece* pieceAt(int index) const {
+        Piece* p = cells[index];
+        return p == OFFBOARD ? nullptr : p;
+    }
+    void placePieceAt(int index, Piece* piece);
+    void removePieceAt(int index);
+    void movePieceAt(int from, int to);
+
+    // Zobrist key of the pieces on the board, kept up to date by every
+    // place, remove and move.
+    uint64_t getHash() const { return hash; }
+
+    bool hasBitboards() const { return bits.index() != 0; }
+
+    // Calls fn(position) with the concrete BitboardPosition<Set> and returns
+    // true, or returns false when the board is too large for bitboards.
+    template <typename Fn>
+    bool withBitboards(Fn&& fn) const {
+        return std::visit([&](const auto& pos) {
+            if constexpr (std::is_same_v<std::decay_t<decltype(pos)>, std::monostate>) {
+                return false;
+            } else {
+                fn(pos);
+                return true;
+            }
+        }, bits);
+    }
+
+    // Calls fn(shape) with this board's BoardShape and returns its result.
+    template <typename Fn>
+    decltype(auto) withShape(Fn&& fn) const { return withBoardShape(size, fn); }
+
+    // getPieceAt for a kernel that already holds the board's shape.
+    template <typename Shape>
+    Piece* getPieceAt(const Shape& shape, int x, int y) const {
+        return shape.contains(x, y) ? cells[shape.toIndex(x, y)] : nullptr;
+    }
+
+    int toSquare(int index) const { return indexToY(index) * size + indexToX(index); }
+    int squareToIndex(int sq) const { return toIndex(sq % size, sq / size); }
+
+    // Locates the first piece of the given type and color; returns false if
+    // there is none. Constant time when the color has one such piece.
+    bool findPiece(int typeId, int colorId, int& x, int& y) const;
+
+    // Number of pieces of the given type and color on the board.
+    int pieceCount(int typeId, int colorId) const;
+
+    // Number of pieces of the color with the royal ability; a side that has
+    // none left has lost.
+    int royalCount(int colorId) const { return colorId < NO_COLOR ? royals[colorId] : 0; }
+
+    // Calls fn(sq) for the square of every piece of the given type and
+    // color, in no particular order. Types beyond Piece::MAX_TYPES are not
+    // listed.
+    template <typename Fn>
+    void forEachSquareOf(int typeId, int colorId, Fn&& fn) const {
+        if (colorId >= NO_COLOR || typeId >= Piece::MAX_TYPES) return;
+        for (int sq = listHead[colorId][typeId]; sq >= 0; sq = nextInList[sq]) fn(sq);
+    }
+
+    // Calls fn(piece, x, y) for every piece of the given color.
+    template <typename Fn>
+    void forEachPiece(int colorId, Fn&& fn) const {
+        if (colorId < NO_COLOR && withBitboards([&](const auto& pos) {
+                pos.pieces(colorId).forEach([&](int sq) {
+                    fn(cells[squareToIndex(sq)], sq % size, sq / size);
+                });
+            })) {
+            return;
+        }
+        for (int y = 0; y < size; ++y) {
+            for (int x = 0; x < size; ++x) {
+                Piece* piece = cells[toIndex(x, y)];
+                if (piece && piece->getColorId() == colorId) fn(piece, x, y);
+            }
+        }
+    }
+};
@@ -2,6 +2,7 @@
 #include <nlohmann/json.hpp>
 #include <fstream>
 #include <iostream>
+#include "PieceDefinition.h"
 #include "Position.h"
 
 using json = nlohmann::json;
@@ -52,6 +53,7 @@ void ConfigReader::parseGameSettings(const json &jsonData) {
     m_config.game_settings.name = settings["name"];
     m_config.game_settings.board_size = settings["board_size"];
     m_config.game_settings.turn_limit = settings["turn_limit"];
+    if (settings.contains("hash_size_mb")) m_config.game_settings.hash_size_mb = settings["hash_size_mb"];
 }
 
 void ConfigReader::parsePieces(const json &jsonData) {
@@ -75,6 +77,9 @@ void ConfigReader::parsePieces(const json &jsonData) {
             if (mv.contains("diagonal")) config.movement.diagonal = mv["diagonal"];
             if (mv.contains("l_shape")) config.movement.l_shape = mv["l_shape"];
             if (mv.contains("diagonal_capture")) config.movement.diagonal_capture = mv["diagonal_capture"];
+            if (mv.contains("attack_range")) config.movement.attack_range = mv["attack_range"];
+            if (mv.contains("attack_min_range")) config.movement.attack_min_range = mv["attack_min_range"];
+            if (mv.contains("attack_line_of_sight")) config.movement.attack_line_of_sight = mv["attack_line_of_sight"];
             if (mv.contains("first_move_forward")) config.movement.first_move_forward = mv["first_move_forward"];
         }
 
@@ -82,6 +87,7 @@ void ConfigReader::parsePieces(const json &jsonData) {
             parseSpecialAbilities(piece["special_abilities"], config.special_abilities);
         }
 
+        PieceDefinition::define(config);
         m_config.pieces.push_back(config);
     }
 }
@@ -21,6 +21,9 @@ struct Movement {
   int diagonal = 0;
   bool l_shape = false;
   int diagonal_capture = 0;
+  int attack_range = 0;
+  int attack_min_range = 0;
+  bool attack_line_of_sight = false;
   int first_move_forward = 0;
 };
 
@@ -62,6 +65,7 @@ struct GameConfig {
     std::string name;
     int board_size;
     int turn_limit;
+    int hash_size_mb = 16;
   } game_settings;
 
   std::vector<PieceConfig> pieces;
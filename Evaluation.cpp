@@ -0,0 +1,85 @@
+#include "Evaluation.h"
+#include <algorithm>
+#include <map>
+#include <vector>
+
+namespace eval {
+
+namespace {
+const int PAWN_TYPE = Piece::typeIdOf("Pawn");
+
+std::vector<int> typeValues;
+
+const std::map<std::string, int> STANDARD_VALUES = {
+    {"Pawn", 100}, {"Knight", 320}, {"Bishop", 330}, {"Rook", 500}, {"Queen", 900}, {"King", ROYAL_VALUE}
+};
+
+int derivedValue(int forward, int sideways, int diagonal, bool lShape, bool jumpOver, bool ranged,
+                 bool royal, bool promotion) {
+    if (royal) return ROYAL_VALUE;
+    if (promotion) return 100;
+    int orthogonal = std::min(std::max(forward, sideways), 8);
+    int value = 60 + 55 * orthogonal + 34 * std::min(diagonal, 8);
+    if (lShape) value += 260;
+    if (jumpOver) value += 30;
+    if (ranged) value += 100;
+    return value;
+}
+
+int valueOf(int typeId) {
+    auto standard = STANDARD_VALUES.find(Piece::typeNameOf(typeId));
+    if (standard != STANDARD_VALUES.end()) return standard->second;
+    const PieceDefinition& definition = PieceDefinition::get(typeId);
+    const PieceMovement& movement = definition.movement;
+    return derivedValue(movement.forward, movement.sideways, movement.diagonal, movement.lShape,
+                        definition.has(ABILITY_JUMP_OVER), definition.has(ABILITY_RANGED_ATTACK),
+                        definition.has(ABILITY_ROYAL), definition.has(ABILITY_PROMOTION));
+}
+
+// Stored at init; a type defined later is valued on the spot.
+int typeValue(int typeId) {
+    if (typeId < static_cast<int>(typeValues.size()) && typeValues[typeId] >= 0) return typeValues[typeId];
+    return valueOf(typeId);
+}
+}
+
+void init(const GameConfig&) {
+    // The config's types were defined while it was read, so this covers
+    // them along with any type defined from code.
+    std::vector<int> values(Piece::typeCount(), -1);
+    for (int typeId = 0; typeId < Piece::typeCount(); ++typeId) {
+        if (PieceDefinition::isDefined(typeId)) values[typeId] = valueOf(typeId);
+    }
+    typeValues = std::move(values);
+}
+
+int pieceValue(const Piece* piece) {
+    return typeValue(piece->getTypeId());
+}
+
+int evaluate(const GameState& state) {
+    const ChessBoard& board = state.board;
+    int size = board.getSize();
+    int types = Piece::typeCount();
+    int score[2] = {0, 0};
+    for (int color = WHITE; color <= BLACK; ++color) {
+        // Material from the piece counts, one value lookup per type.
+        for (int type = 0; type < std::min(types, static_cast<int>(Piece::MAX_TYPES)); ++type) {
+            int count = board.pieceCount(type, color);
+            if (count != 0) score[color] += count * typeValue(type);
+        }
+        if (types > Piece::MAX_TYPES) {
+            board.forEachPiece(color, [&](Piece* piece, int, int) {
+                if (piece->getTypeId() >= Piece::MAX_TYPES) score[color] += pieceValue(piece);
+            });
+        }
+        board.forEachSquareOf(PAWN_TYPE, color, [&](int sq) {
+            int y = sq / size;
+            score[color] += 5 * (color == WHITE ? y - 1 : size - 2 - y);
+        });
+    }
+    int us = state.sideToMove;
+    return score[us] - score[opponentOf(us)];
+}
+
+}
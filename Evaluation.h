@@ -0,0 +1,22 @@
+#pragma once
+#include "GameState.h"
+
+struct GameConfig;
+
+// Static evaluation in centipawns. Standard pieces use the classical
+// values; any other type is valued from its movement ranges and abilities
+// as declared in the config.
+namespace eval {
+
+constexpr int ROYAL_VALUE = 10000;
+
+// Precomputes the value of every defined type, the config's included.
+void init(const GameConfig& config);
+
+int pieceValue(const Piece* piece);
+
+// Material plus a small bonus for advanced pawns, from the side to move's
+// point of view.
+int evaluate(const GameState& state);
+
+}
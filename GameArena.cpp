@@ -0,0 +1,28 @@
+#include "GameArena.h"
+
+void* GameArena::allocate(size_t bytes, size_t alignment) {
+    if (bytes > BLOCK_BYTES) {
+        // Kept in front of the current block, which stays open for small
+        // requests.
+        auto at = blocks.empty() ? blocks.end() : blocks.end() - 1;
+        char* block = blocks.emplace(at, new char[bytes])->get();
+        allocated += bytes;
+        return block;
+    }
+    size_t offset = (used + alignment - 1) & ~(alignment - 1);
+    if (blocks.empty() || offset + bytes > BLOCK_BYTES) {
+        blocks.emplace_back(new char[BLOCK_BYTES]);
+        allocated += BLOCK_BYTES;
+        offset = 0;
+    }
+    used = offset + bytes;
+    return blocks.back().get() + offset;
+}
+
+Piece* GameArena::piece(int typeId, int colorId) {
+    if (colorId != WHITE && colorId != BLACK) return nullptr;
+    size_t slot = static_cast<size_t>(typeId) * 2 + colorId;
+    if (slot >= pieces.size()) pieces.resize(slot + 1, nullptr);
+    if (!pieces[slot]) pieces[slot] = create<Piece>(typeId, colorId);
+    return pieces[slot];
+}
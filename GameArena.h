@@ -0,0 +1,48 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "Piece.h"
+
+// Owns the objects of one game. Storage is carved out of large blocks and
+// released all at once when the arena is destroyed, so nothing created
+// here is freed individually and only trivially destructible types may be
+// placed in it.
+//
+// Pieces are immutable (a type id and a color), so the arena keeps a pool
+// of one slot per type and color: every piece of that kind on the board,
+// every promotion to it and every captured one held by an undo record
+// refers to the same slot. Promotions and captures therefore never
+// allocate.
+class GameArena {
+public:
+    static constexpr size_t BLOCK_BYTES = 4096;
+
+    GameArena() = default;
+    GameArena(const GameArena&) = delete;
+    GameArena& operator=(const GameArena&) = delete;
+
+    template <typename T, typename... Args>
+    T* create(Args&&... args) {
+        static_assert(std::is_trivially_destructible<T>::value, "arena objects are never destroyed");
+        static_assert(sizeof(T) <= BLOCK_BYTES, "arena objects must fit in one block");
+        return new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+    }
+
+    // Requests larger than a block get a block of their own.
+    void* allocate(size_t bytes, size_t alignment);
+
+    // The pooled piece for a type and color, created on first use.
+    Piece* piece(int typeId, int colorId);
+
+    size_t bytesAllocated() const { return allocated; }
+
+private:
+    std::vector<std::unique_ptr<char[]>> blocks;
+    size_t used = BLOCK_BYTES;
+    size_t allocated = 0;
+    std::vector<Piece*> pieces;  // [typeId * 2 + colorId]
+};
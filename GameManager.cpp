@@ -1,16 +1,23 @@
 #include "GameManager.h"
+#include "GameArena.h"
+#include "MoveGenerator.h"
 #include <iostream>
 
 GameManager::GameManager() : gameOver(false), currentPlayer("white") {
-    board = new ChessBoard(8);
+    auto arena = std::make_shared<GameArena>();
+    int queen = PieceDefinition::define("Queen", {{"forward", 8}, {"sideways", 8}, {"diagonal", 8}}, {});
+    game = new GameState(ChessBoard(8), {});
+    game->setPromotionPieces({arena->piece(queen, WHITE), arena->piece(queen, BLACK)});
+    game->setArena(arena);
+    board = &game->board;
     validator = new MoveValidator(board);
     printer = new BoardPrinter(board);
     // Initialize lastMove
-    lastMove = {0, 0, 0, 0, ""};
+    lastMove = {0, 0, 0, 0, -1};
 }
 
 GameManager::~GameManager() {
-    delete board;
+    delete game;
     delete validator;
     delete printer;
 }
@@ -30,63 +37,29 @@ void GameManager::makeMove(int fromX, int fromY, int toX, int toY) {
     std::cout << "Piece type: " << piece->getType() << ", Color: " << piece->getColor() << std::endl;
 
     // Validate move
-    if (!validator->validateMove(piece, fromX, fromY, toX, toY, {})) {
+    if (!validator->validateMove(piece, fromX, fromY, toX, toY, game->portals)) {
         std::cout << "Invalid move!" << std::endl;
         return;
     }
 
-    // Check for adjacent pawn capture
-    if (piece->getType() == "Pawn" && std::abs(toX - fromX) == 1 && std::abs(toY - fromY) == 1) {
-        Piece* targetPiece = board->getPieceAt(toX, toY);
-        if (!targetPiece) {
-            // This is an adjacent pawn capture
-            // Check the square where the pawn was passed
-            int passedPawnY = (toY > fromY) ? fromY : toY; // Use the lower Y coordinate
-            Piece* passedPawn = board->getPieceAt(toX, passedPawnY);
-            if (passedPawn && passedPawn->getType() == "Pawn" && passedPawn->getColor() != piece->getColor()) {
-                std::cout << "Capturing passed pawn at " << toX << "," << passedPawnY << std::endl;
-                board->removePiece(toX, passedPawnY);
-            }
-        }
+    Move move = MoveGenerator(*game).moveFor(piece, fromX, fromY, toX, toY, false);
+    if (move.is(MOVE_EN_PASSANT)) {
+        std::cout << "Capturing passed pawn at " << toX << "," << fromY << std::endl;
     }
 
-    // Store move information
-    lastMove = {fromX, fromY, toX, toY, piece->getType()};
-
-    // Make the move
-    board->movePiece(fromX, fromY, toX, toY);
-    moveHistory.push({{fromX, fromY}, {toX, toY}});
-
-    // Check for pawn promotion
-    if (piece->getType() == "Pawn" && (toY == 0 || toY == 7)) {
-        // Promote to queen (you can add a method to let the player choose the piece)
-        board->removePiece(toX, toY);
-        board->placePiece(toX, toY, new Piece("Queen", currentPlayer, {{"forward", 8}, {"sideways", 8}, {"diagonal", 8}}, {}));
-    }
+    // Make the move; pawns reaching the last rank promote to a queen
+    game->sideToMove = piece->getColorId();
+    game->makeMove(move);
+    lastMove = game->lastMove;
 
     switchPlayer();
 }
 
 void GameManager::undoMove() {
-    if (moveHistory.empty()) return;
-
-    auto lastMove = moveHistory.top();
-    moveHistory.pop();
-
-    int fromX = lastMove.first.first;
-    int fromY = lastMove.first.second;
-    int toX = lastMove.second.first;
-    int toY = lastMove.second.second;
-
-    // Check if it was an en passant capture
-    Piece* movedPiece = board->getPieceAt(toX, toY);
-    if (movedPiece && movedPiece->getType() == "Pawn" && std::abs(toX - fromX) == 1 && std::abs(toY - fromY) == 1) {
-        // Restore the captured pawn
-        std::string capturedColor = (movedPiece->getColor() == "white") ? "black" : "white";
-        board->placePiece(toX, fromY, new Piece("Pawn", capturedColor, {{"forward", 1}}, {}));
-    }
+    if (game->historySize() == 0) return;
 
-    board->movePiece(toX, toY, fromX, fromY);
+    game->unmakeMove();
+    lastMove = game->lastMove;
     switchPlayer();
 }
 
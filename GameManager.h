@@ -5,22 +5,17 @@
 #include "ChessBoard.h"
 #include "MoveValidator.h"
 #include "BoardPrinter.h"
-#include <stack>
+#include "GameState.h"
+#include "Move.h"
 #include <string>
 
-// Store last move information for en passant
-struct LastMove {
-    int fromX, fromY, toX, toY;
-    std::string pieceType;
-};
-
 class GameManager {
 private:
+    GameState* game;
     ChessBoard* board;
     MoveValidator* validator;
     BoardPrinter* printer;
     std::string currentPlayer;
-    std::stack<std::pair<std::pair<int, int>, std::pair<int, int>>> moveHistory;
     bool gameOver;
     LastMove lastMove;
 
@@ -0,0 +1,57 @@
+#include "GameSetup.h"
+
+Piece* createPiece(GameArena& arena, const PieceConfig& pieceCfg, const std::string& color) {
+    int typeId = Piece::typeIdOf(pieceCfg.type);
+    if (!PieceDefinition::isDefined(typeId)) PieceDefinition::define(pieceCfg);
+    return arena.piece(typeId, Piece::colorIdOf(color));
+}
+
+ChessBoard createBoard(const GameConfig& config, GameArena& arena) {
+    ChessBoard board(config.game_settings.board_size);
+    for (const auto* pieces : {&config.pieces, &config.custom_pieces}) {
+        for (const auto& pieceCfg : *pieces) {
+            for (const auto& [color, positions] : pieceCfg.positions) {
+                for (const auto& pos : positions) {
+                    Piece* piece = createPiece(arena, pieceCfg, color);
+                    if (piece) board.placePiece(pos.x, pos.y, piece);
+                }
+            }
+        }
+    }
+    return board;
+}
+
+std::vector<Portal> createPortals(const GameConfig& config) {
+    std::vector<Portal> portals;
+    for (const auto& pc : config.portals) {
+        portals.emplace_back(
+            pc.id,
+            pc.positions.entry,
+            pc.positions.exit,
+            pc.properties.preserve_direction,
+            pc.properties.allowed_colors,
+            pc.properties.cooldown
+        );
+    }
+    return portals;
+}
+
+std::vector<Piece*> createPromotionPieces(const GameConfig& config, GameArena& arena) {
+    std::vector<Piece*> pieces;
+    for (const auto* group : {&config.pieces, &config.custom_pieces}) {
+        for (const auto& pieceCfg : *group) {
+            if (pieceCfg.special_abilities.royal || pieceCfg.special_abilities.promotion) continue;
+            pieces.push_back(createPiece(arena, pieceCfg, "white"));
+            pieces.push_back(createPiece(arena, pieceCfg, "black"));
+        }
+    }
+    return pieces;
+}
+
+GameState createGameState(const GameConfig& config) {
+    auto arena = std::make_shared<GameArena>();
+    GameState state(createBoard(config, *arena), createPortals(config));
+    state.setPromotionPieces(createPromotionPieces(config, *arena));
+    state.setArena(arena);
+    return state;
+}
@@ -0,0 +1,23 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "ChessBoard.h"
+#include "ConfigReader.hpp"
+#include "GameArena.h"
+#include "GameState.h"
+#include "Piece.h"
+#include "Portal.h"
+
+// Builds the starting position described by a loaded config. Pieces come
+// from the arena's pool and live as long as the arena.
+Piece* createPiece(GameArena& arena, const PieceConfig& pieceCfg, const std::string& color);
+ChessBoard createBoard(const GameConfig& config, GameArena& arena);
+std::vector<Portal> createPortals(const GameConfig& config);
+
+// One piece per color for every type a pawn may promote to: anything that
+// is neither royal nor itself promotable.
+std::vector<Piece*> createPromotionPieces(const GameConfig& config, GameArena& arena);
+
+// A new game with its own arena, shared by every copy of the state and
+// freed when the last one goes away.
+GameState createGameState(const GameConfig& config);
@@ -0,0 +1,204 @@
+#include "GameState.h"
+#include "MoveValidator.h"
+#include "TranspositionTable.h"
+#include "Zobrist.h"
+#include <cstdlib>
+
+namespace {
+const int PAWN_TYPE = Piece::typeIdOf("Pawn");
+}
+
+GameState::GameState(const ChessBoard& board, const std::vector<Portal>& portals)
+    : board(board), portals(portals), portalMap(portals, board.getSize()),
+      usedPortals((portals.size() + 63) / 64, 0) {
+    reserveHistory();
+    for (int i = 0; i < static_cast<int>(portals.size()); ++i) {
+        if (!portals[i].isAvailable(turn)) usedPortals[i >> 6] |= uint64_t(1) << (i & 63);
+    }
+}
+
+GameState::GameState(const GameState& other)
+    : board(other.board), portals(other.portals), lastMove(other.lastMove), sideToMove(other.sideToMove),
+      turn(other.turn), portalMap(other.portalMap), arena(other.arena), promotionPieces(other.promotionPieces),
+      usedPortals(other.usedPortals), table(other.table), undoStack(other.undoStack), attacks(other.attacks) {
+    reserveHistory();
+}
+
+void GameState::reserveHistory() {
+    undoStack.reserve(UNDO_CAPACITY);
+}
+
+const Portal* GameState::portalAt(int x, int y, int color) const {
+    if (!board.isValidPosition(x, y)) return nullptr;
+    int sq = y * board.getSize() + x;
+    for (const PortalMap::Hop* hop = portalMap.begin(sq); hop != portalMap.end(sq); ++hop) {
+        if (portals[hop->portal].isColorAllowed(color)) return &portals[hop->portal];
+    }
+    return nullptr;
+}
+
+Piece* GameState::promotionPiece(int typeId, int colorId) const {
+    for (Piece* piece : promotionPieces) {
+        if (piece->getTypeId() == typeId && piece->getColorId() == colorId) return piece;
+    }
+    return nullptr;
+}
+
+void GameState::trackAttacks(bool on) {
+    if (on) attacks.build(*this);
+    else attacks.clear();
+}
+
+void GameState::refreshAttacks(const UndoRecord& undo, int turnBefore) {
+    if (attacks.empty() || !undo.moved) return;
+    int squares[4] = {undo.move.from, undo.move.to, undo.captureSquare, undo.finalSquare};
+    attacks.update(*this, squares, undo.move.is(MOVE_RANGED) ? 2 : 4, turnBefore);
+}
+
+void GameState::applyMove(const Move& move) {
+    if (attacks.empty()) {
+        doMove(move, nullptr);
+        return;
+    }
+    UndoRecord undo;
+    undo.move = move;
+    int turnBefore = turn;
+    doMove(move, &undo);
+    refreshAttacks(undo, turnBefore);
+}
+
+void GameState::makeMove(const Move& move) {
+    undoStack.emplace_back();
+    UndoRecord& undo = undoStack.back();
+    undo.move = move;
+    undo.lastMove = lastMove;
+    undo.turn = turn;
+    doMove(move, &undo);
+    refreshAttacks(undo, undo.turn);
+}
+
+void GameState::unmakeMove() {
+    if (undoStack.empty()) return;
+    const UndoRecord& undo = undoStack.back();
+    int turnBefore = turn;
+    if (undo.portal >= 0) {
+        portals[undo.portal].setAvailableAt(undo.portalAvailableAt);
+        if (!undo.portalWasUsed) usedPortals[undo.portal >> 6] &= ~(uint64_t(1) << (undo.portal & 63));
+    }
+    turn = undo.turn;
+    lastMove = undo.lastMove;
+
+    if (undo.moved) {
+        sideToMove = opponentOf(sideToMove);
+        int from = board.squareToIndex(undo.move.from);
+        if (undo.move.is(MOVE_RANGED)) {
+            board.placePieceAt(board.squareToIndex(undo.move.to), undo.captured);
+        } else {
+            int finalIndex = board.squareToIndex(undo.finalSquare);
+            board.removePieceAt(finalIndex);
+            if (undo.displaced) board.placePieceAt(finalIndex, undo.displaced);
+            board.placePieceAt(from, undo.moved);
+            if (undo.captured) board.placePieceAt(board.squareToIndex(undo.captureSquare), undo.captured);
+        }
+    }
+    refreshAttacks(undo, turnBefore);
+    undoStack.pop_back();
+}
+
+void GameState::doMove(const Move& move, UndoRecord* undo) {
+    int size = board.getSize();
+    int fromX = move.from % size, fromY = move.from / size;
+    int toX = move.to % size, toY = move.to / size;
+    Piece* piece = board.getPieceAt(fromX, fromY);
+    if (!piece) return;
+    if (undo) undo->moved = piece;
+
+    // A ranged attack removes the target and, like the REPL's attack
+    // command, does not advance portal cooldowns.
+    if (move.is(MOVE_RANGED)) {
+        if (undo) undo->captured = board.getPieceAt(toX, toY);
+        board.removePiece(toX, toY);
+        lastMove = {fromX, fromY, fromX, fromY, -1};
+        sideToMove = opponentOf(sideToMove);
+        return;
+    }
+
+    int captureY = move.is(MOVE_EN_PASSANT) ? fromY : toY;
+    if (undo) {
+        undo->captured = board.getPieceAt(toX, captureY);
+        undo->captureSquare = static_cast<uint16_t>(captureY * size + toX);
+    }
+    if (move.is(MOVE_EN_PASSANT)) board.removePiece(toX, fromY);
+    board.movePiece(fromX, fromY, toX, toY);
+
+    int finalX = toX, finalY = toY;
+    int to = toY * size + toX;
+    for (const PortalMap::Hop* hop = portalMap.begin(to); hop != portalMap.end(to); ++hop) {
+        Portal& portal = portals[hop->portal];
+        if (!portal.isColorAllowed(piece->getColorId())) continue;
+        if (portal.isAvailable(turn)) {
+            Position exit = portal.getExit();
+            if (undo) {
+                undo->displaced = board.getPieceAt(exit.x, exit.y);
+                undo->portal = hop->portal;
+                undo->portalAvailableAt = portal.getAvailableAt();
+                undo->portalWasUsed = (usedPortals[hop->portal >> 6] >> (hop->portal & 63)) & 1;
+            }
+            board.movePiece(toX, toY, exit.x, exit.y);
+            portal.startCooldown(turn);
+            usedPortals[hop->portal >> 6] |= uint64_t(1) << (hop->portal & 63);
+            finalX = exit.x;
+            finalY = exit.y;
+        }
+        break;
+    }
+    if (undo) undo->finalSquare = static_cast<uint16_t>(finalY * size + finalX);
+
+    if (move.is(MOVE_PROMOTION)) {
+        Piece* promoted = promotionPiece(move.promotion, piece->getColorId());
+        if (promoted) board.placePiece(finalX, finalY, promoted);
+    }
+
+    lastMove = {fromX, fromY, finalX, finalY, piece->getTypeId()};
+    ++turn;
+    sideToMove = opponentOf(sideToMove);
+}
+
+bool GameState::isInCheck(int color) const {
+    bool inCheck;
+    uint64_t key = table ? hash() : 0;
+    if (table && table->probeCheck(key, color, inCheck)) return inCheck;
+    MoveValidator validator(*this);
+    inCheck = validator.isKingInCheck(color, portals);
+    if (table) table->storeCheck(key, color, inCheck);
+    return inCheck;
+}
+
+bool GameState::isCheckmate(int color) const {
+    bool checkmate;
+    uint64_t key = table ? hash() : 0;
+    if (table && table->probeCheckmate(key, color, checkmate)) return checkmate;
+    MoveValidator validator(*this);
+    checkmate = validator.isCheckmate(color, portals);
+    if (table) table->storeCheckmate(key, color, checkmate);
+    return checkmate;
+}
+
+bool GameState::isGameOver() const {
+    return board.royalCount(WHITE) == 0 || board.royalCount(BLACK) == 0;
+}
+
+uint64_t GameState::hash() const {
+    uint64_t key = board.getHash();
+    for (int word = 0; word < static_cast<int>(usedPortals.size()); ++word) {
+        for (uint64_t bits = usedPortals[word]; bits; bits &= bits - 1) {
+            int portal = word * 64 + __builtin_ctzll(bits);
+            key ^= zobrist::portalKey(portal, portals[portal].cooldownRemaining(turn));
+        }
+    }
+    if (sideToMove == BLACK) key ^= zobrist::sideKey();
+    if (lastMove.pieceType == PAWN_TYPE && std::abs(lastMove.toY - lastMove.fromY) == 2) {
+        key ^= zobrist::enPassantKey(lastMove.toX);
+    }
+    return key;
+}
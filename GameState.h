@@ -0,0 +1,119 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "AttackMap.h"
+#include "ChessBoard.h"
+#include "Move.h"
+#include "Piece.h"
+#include "Portal.h"
+#include "PortalMap.h"
+
+class GameArena;
+class TranspositionTable;
+
+// Everything makeMove changes that cannot be recomputed on the way back.
+struct UndoRecord {
+    Move move;
+    Piece* moved = nullptr;      // the piece that moved, before any promotion
+    Piece* captured = nullptr;   // removed from captureSquare
+    Piece* displaced = nullptr;  // overwritten on the portal exit it teleported to
+    uint16_t captureSquare = 0;
+    uint16_t finalSquare = 0;
+    LastMove lastMove;
+    int turn = 0;
+    int portal = -1;               // portal the move went through, if any
+    int portalAvailableAt = 0;     // its availability before the move
+    bool portalWasUsed = false;    // its bit in usedPortals before the move
+};
+
+// A self-contained game position: the board, portal cooldowns, the last
+// move (for en passant) and the side to move. Moves are applied with the
+// same rules the REPL uses, including portal teleports and the end-of-turn
+// cooldown tick, which only advances the turn counter.
+//
+// applyMove changes the position for good (copy-make); makeMove also
+// records how to take the move back, and unmakeMove restores the exact
+// prior state. The undo buffers are reserved up front and reused, so a
+// make/unmake pair does not allocate.
+class GameState {
+public:
+    static constexpr int UNDO_CAPACITY = 256;
+
+    ChessBoard board;
+    std::vector<Portal> portals;
+    LastMove lastMove = {0, 0, 0, 0, -1};
+    int sideToMove = WHITE;
+    // Portal cooldown ticks so far, one per move other than a ranged
+    // attack; portals compare it against their availableAt turn.
+    int turn = 0;
+
+    GameState(const ChessBoard& board, const std::vector<Portal>& portals);
+    // Copies reserve their own undo buffers, so the first makeMove on a
+    // copy does not allocate either.
+    GameState(const GameState& other);
+    GameState(GameState&&) = default;
+    GameState& operator=(const GameState&) = default;
+    GameState& operator=(GameState&&) = default;
+
+    // The arena that owns this game's pieces; copies of the state share it,
+    // so it outlives every position that can still refer to its pieces.
+    void setArena(std::shared_ptr<GameArena> arena) { this->arena = std::move(arena); }
+    GameArena* getArena() const { return arena.get(); }
+
+    // Pieces a promoting pawn may turn into, one per type and color.
+    void setPromotionPieces(const std::vector<Piece*>& pieces) { promotionPieces = pieces; }
+    const std::vector<Piece*>& getPromotionPieces() const { return promotionPieces; }
+
+    // Optional cache for check and checkmate results; copies of the state
+    // share it.
+    void setTranspositionTable(TranspositionTable* table) { this->table = table; }
+    TranspositionTable* getTranspositionTable() const { return table; }
+
+    // Keeps per-color attack counts up to date through every move from now
+    // on (see AttackMap), or stops doing so. Copies of the state keep
+    // tracking when the original does.
+    void trackAttacks(bool on = true);
+    // The attack counts of this position, or nullptr when not tracked.
+    const AttackMap* getAttackMap() const { return attacks.empty() ? nullptr : &attacks; }
+
+    void applyMove(const Move& move);
+    void makeMove(const Move& move);
+    void unmakeMove();
+    int historySize() const { return static_cast<int>(undoStack.size()); }
+    bool isInCheck(int color) const;
+    bool isCheckmate(int color) const;
+    // A side has lost its last royal piece (its king, in the standard
+    // set), which ends the game at the REPL.
+    bool isGameOver() const;
+
+    // Zobrist key of the whole position: pieces, side to move, en passant
+    // file and the cooldowns left on portals.
+    uint64_t hash() const;
+
+    // The portals indexed by square.
+    const PortalMap& getPortalMap() const { return portalMap; }
+
+    // First portal whose entry is (x, y) and which admits the color, if any.
+    const Portal* portalAt(int x, int y, int color) const;
+
+private:
+    PortalMap portalMap;
+    std::shared_ptr<GameArena> arena;
+    std::vector<Piece*> promotionPieces;
+    // Bit per portal that has been used on the way to this position; only
+    // those can still be cooling down.
+    std::vector<uint64_t> usedPortals;
+    TranspositionTable* table = nullptr;
+    std::vector<UndoRecord> undoStack;
+    AttackMap attacks;
+
+    void reserveHistory();
+    void refreshAttacks(const UndoRecord& undo, int turnBefore);
+    Piece* promotionPiece(int typeId, int colorId) const;
+    void doMove(const Move& move, UndoRecord* undo);
+};
+
+inline const std::string& colorName(int color) { return Piece::colorNameOf(color); }
+inline int opponentOf(int color) { return color == WHITE ? BLACK : WHITE; }
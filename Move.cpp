@@ -0,0 +1,10 @@
+#include "Move.h"
+#include "Piece.h"
+
+std::string moveToString(const Move& move, int boardSize) {
+    std::string text = std::to_string(move.from % boardSize) + " " + std::to_string(move.from / boardSize) + " " +
+                       std::to_string(move.to % boardSize) + " " + std::to_string(move.to / boardSize);
+    if (move.is(MOVE_PROMOTION)) text += "=" + Piece::typeNameOf(move.promotion);
+    if (move.is(MOVE_RANGED)) text += "!";
+    return text;
+}
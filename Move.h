@@ -0,0 +1,63 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Store last move information for en passant
+struct LastMove {
+    int fromX, fromY, toX, toY;
+    int pieceType;  // type id of the moved piece, -1 if none
+};
+
+enum MoveFlag : uint8_t {
+    MOVE_QUIET = 0,
+    MOVE_CAPTURE = 1 << 0,
+    MOVE_EN_PASSANT = 1 << 1,
+    MOVE_PROMOTION = 1 << 2,
+    // Lands on a portal entry that is open for the mover and teleports.
+    MOVE_PORTAL = 1 << 3,
+    // Archer-style shot: the target is removed and the shooter stays put.
+    MOVE_RANGED = 1 << 4
+};
+
+// Squares are numbered y * boardSize + x.
+struct Move {
+    uint16_t from = 0;
+    uint16_t to = 0;
+    uint8_t flags = MOVE_QUIET;
+    uint8_t promotion = 0;  // type id of the promoted piece
+
+    bool is(MoveFlag flag) const { return (flags & flag) != 0; }
+    bool operator==(const Move& o) const {
+        return from == o.from && to == o.to && flags == o.flags && promotion == o.promotion;
+    }
+    bool operator!=(const Move& o) const { return !(*this == o); }
+};
+
+// "x1 y1 x2 y2" as typed at the REPL, with "=Type" for promotions and a
+// trailing "!" for ranged attacks.
+std::string moveToString(const Move& move, int boardSize);
+
+// Move buffer whose storage is reserved once, up front, and reused across
+// clear() calls, so generation into a reused list never allocates. A
+// position with more moves than the reserved capacity (only plausible on
+// very large boards) grows the buffer instead of dropping moves.
+class MoveList {
+public:
+    static constexpr int DEFAULT_CAPACITY = 1024;
+
+    explicit MoveList(int capacity = DEFAULT_CAPACITY) { moves.reserve(capacity); }
+
+    void clear() { moves.clear(); }
+    void push(const Move& move) { moves.push_back(move); }
+    void truncate(int size) { moves.resize(size); }
+    int size() const { return static_cast<int>(moves.size()); }
+    bool empty() const { return moves.empty(); }
+    const Move& operator[](int i) const { return moves[i]; }
+    Move& operator[](int i) { return moves[i]; }
+    const Move* begin() const { return moves.data(); }
+    const Move* end() const { return moves.data() + moves.size(); }
+
+private:
+    std::vector<Move> moves;
+};
@@ -0,0 +1,292 @@
+#include "MoveGenerator.h"
+#include "CheckInfo.h"
+#include "RangedAttacks.h"
+#include "ReachSearch.h"
+#include "SliderAttacks.h"
+#include <algorithm>
+#include <cstdlib>
+
+namespace {
+const int PAWN_TYPE = Piece::typeIdOf("Pawn");
+
+const int KNIGHT_DX[8] = {2, 1, -1, -2, -2, -1, 1, 2};
+const int KNIGHT_DY[8] = {1, 2, 2, 1, -1, -2, -2, -1};
+
+// Per-thread target set, search kernel and legality masks, sized on
+// first use so that generation does not allocate afterwards.
+struct Scratch {
+    std::vector<uint64_t> targets;
+    std::vector<uint64_t> depends;
+    ReachSearch search;
+    CheckInfo checks;
+    MoveList moves;
+};
+
+Scratch& scratch() {
+    thread_local Scratch buffers;
+    return buffers;
+}
+}
+
+MoveGenerator::MoveGenerator(const GameState& state) : state(state) {}
+
+void MoveGenerator::generatePseudoLegalMoves(int color, MoveList& moves) const {
+    state.board.withShape([&](const auto& shape) {
+        state.board.forEachPiece(color, [&](Piece* piece, int x, int y) {
+            generatePieceMoves(shape, piece, x, y, moves);
+        });
+    });
+}
+
+void MoveGenerator::generateMoves(int color, MoveList& moves) const {
+    int first = moves.size();
+    generatePseudoLegalMoves(color, moves);
+    CheckInfo& checks = scratch().checks;
+    checks.compute(state, color);
+    int kept = first;
+    for (int i = first; i < moves.size(); ++i) {
+        if (checks.isLegal(moves[i])) moves[kept++] = moves[i];
+    }
+    moves.truncate(kept);
+}
+
+bool MoveGenerator::hasLegalMove(int color) const {
+    Scratch& buffers = scratch();
+    MoveList& moves = buffers.moves;
+    moves.clear();
+    generatePseudoLegalMoves(color, moves);
+    buffers.checks.compute(state, color);
+    for (const Move& move : moves) {
+        if (buffers.checks.isLegal(move)) return true;
+    }
+    return false;
+}
+
+bool MoveGenerator::isLegal(const Move& move) const {
+    const ChessBoard& board = state.board;
+    Piece* piece = board.getPieceAt(move.from % board.getSize(), move.from / board.getSize());
+    if (!piece) return false;
+    GameState next = state;
+    next.applyMove(move);
+    return !next.isInCheck(piece->getColorId());
+}
+
+Move MoveGenerator::moveFor(Piece* piece, int fromX, int fromY, int toX, int toY, bool ranged) const {
+    int size = state.board.getSize();
+    Move found;
+    found.from = static_cast<uint16_t>(fromY * size + fromX);
+    found.to = static_cast<uint16_t>(toY * size + toX);
+    found.flags = ranged ? MOVE_RANGED | MOVE_CAPTURE : (state.board.getPieceAt(toX, toY) ? MOVE_CAPTURE : MOVE_QUIET);
+
+    MoveList moves;
+    state.board.withShape([&](const auto& shape) { generatePieceMoves(shape, piece, fromX, fromY, moves); });
+    bool matched = false;
+    for (const Move& move : moves) {
+        if (move.to != found.to || move.is(MOVE_RANGED) != ranged) continue;
+        if (!matched || (move.is(MOVE_PROMOTION) && Piece::typeNameOf(move.promotion) == "Queen")) found = move;
+        matched = true;
+    }
+    return found;
+}
+
+template <typename Shape>
+void MoveGenerator::generatePieceMoves(const Shape& shape, Piece* piece, int x, int y, MoveList& moves) const {
+    const ChessBoard& board = state.board;
+    int size = shape.size();
+    const MoveRules& rules = piece->definition().rules;
+
+    if (rules.kernel == MoveKernel::PAWN) {
+        generatePawnMoves(shape, piece, x, y, moves);
+    } else if (rules.kernel == MoveKernel::KING) {
+        generateKingMoves(shape, piece, x, y, moves);
+    } else {
+        Scratch& buffers = scratch();
+        std::vector<uint64_t>& targets = buffers.targets;
+        targets.assign(shape.words(), 0);
+        int from = y * size + x;
+        if (rules.kernel == MoveKernel::CUSTOM) {
+            buffers.depends.assign(shape.words(), 0);
+            withBehavior(rules.behavior, [&](const auto& kind) {
+                kind.markMoves(board, piece, x, y, targets.data(), buffers.depends.data());
+            });
+        } else {
+            generateStepTargets(shape, piece, x, y, targets);
+        }
+        targets[from >> 6] &= ~(uint64_t(1) << (from & 63));
+        for (int word = 0; word < shape.words(); ++word) {
+            for (uint64_t bits = targets[word]; bits; bits &= bits - 1) {
+                int sq = word * 64 + __builtin_ctzll(bits);
+                addMove(shape, piece, x, y, sq % size, sq / size, MOVE_QUIET, moves);
+            }
+        }
+    }
+
+    generateRangedAttacks(shape, piece, x, y, moves);
+}
+
+template <typename Shape>
+void MoveGenerator::generateStepTargets(const Shape& shape, Piece* piece, int x, int y,
+                                        std::vector<uint64_t>& targets) const {
+    const ChessBoard& board = state.board;
+    const MoveRules& rules = piece->definition().rules;
+    int size = shape.size();
+    int from = y * size + x;
+    // The search finds everything else the piece reaches.
+    bool orthogonal = rules.extraOrthogonal;
+    bool diagonal = rules.extraDiagonal;
+    if (orthogonal || diagonal) {
+        if (!board.withBitboards([&](const auto& pos) {
+                if (orthogonal) {
+                    sliders::attacks(pos, from, ORTHOGONAL, sliders::UNLIMITED, pos.occupied)
+                        .forEach([&](int sq) { setBit(targets.data(), sq); });
+                }
+                if (diagonal) {
+                    sliders::attacks(pos, from, DIAGONAL, sliders::UNLIMITED, pos.occupied)
+                        .forEach([&](int sq) { setBit(targets.data(), sq); });
+                }
+            })) {
+            for (int dir = orthogonal ? 0 : 4; dir < (diagonal ? 8 : 4); ++dir) {
+                int index = shape.toIndex(x, y);
+                int step = direction::DX[dir] + direction::DY[dir] * shape.stride();
+                for (index += step; !board.isOffboard(index); index += step) {
+                    setBit(targets.data(), board.toSquare(index));
+                    if (board.cellAt(index)) break;
+                }
+            }
+        }
+    }
+    if (rules.extraKnightLeap) {
+        for (int i = 0; i < 8; ++i) {
+            int nx = x + KNIGHT_DX[i];
+            int ny = y + KNIGHT_DY[i];
+            if (shape.contains(nx, ny)) setBit(targets.data(), ny * size + nx);
+        }
+    }
+    scratch().search.markReachable(board, state.portals, state.getPortalMap(), state.turn, piece, from, targets);
+}
+
+template <typename Shape>
+void MoveGenerator::generatePawnMoves(const Shape& shape, Piece* piece, int x, int y, MoveList& moves) const {
+    const ChessBoard& board = state.board;
+    int color = piece->getColorId();
+    int direction = (color == WHITE) ? 1 : -1;
+    int startRank = (color == WHITE) ? 1 : shape.size() - 2;
+
+    if (shape.contains(x, y + direction) && !board.getPieceAt(shape, x, y + direction)) {
+        addMove(shape, piece, x, y, x, y + direction, MOVE_QUIET, moves);
+        if (y == startRank && shape.contains(x, y + 2 * direction) &&
+            !board.getPieceAt(shape, x, y + 2 * direction)) {
+            addMove(shape, piece, x, y, x, y + 2 * direction, MOVE_QUIET, moves);
+        }
+    }
+
+    const LastMove& last = state.lastMove;
+    for (int dx = -1; dx <= 1; dx += 2) {
+        int toX = x + dx;
+        int toY = y + direction;
+        if (!shape.contains(toX, toY)) continue;
+        Piece* target = board.getPieceAt(shape, toX, toY);
+        if (target) {
+            if (target->getColorId() != color) addMove(shape, piece, x, y, toX, toY, MOVE_QUIET, moves);
+            continue;
+        }
+        // validateMove accepts a diagonal step next to any enemy pawn; it is
+        // an en passant capture only right after that pawn's double step.
+        Piece* adjacent = board.getPieceAt(shape, toX, y);
+        if (adjacent && adjacent->getTypeId() == PAWN_TYPE && adjacent->getColorId() != color) {
+            bool enPassant = last.pieceType == PAWN_TYPE && std::abs(last.toY - last.fromY) == 2 &&
+                             last.toX == toX && last.toY == y;
+            addMove(shape, piece, x, y, toX, toY, enPassant ? MOVE_EN_PASSANT : MOVE_QUIET, moves);
+        }
+    }
+}
+
+template <typename Shape>
+void MoveGenerator::generateKingMoves(const Shape& shape, Piece* piece, int x, int y, MoveList& moves) const {
+    for (int dy = -1; dy <= 1; ++dy) {
+        for (int dx = -1; dx <= 1; ++dx) {
+            if ((dx || dy) && shape.contains(x + dx, y + dy)) {
+                addMove(shape, piece, x, y, x + dx, y + dy, MOVE_QUIET, moves);
+            }
+        }
+    }
+    // A king may also hop along a portal open to it, in either direction.
+    int color = piece->getColorId();
+    int size = shape.size();
+    int from = y * size + x;
+    const PortalMap& portalMap = state.getPortalMap();
+    auto hopTo = [&](const PortalMap::Hop& hop) {
+        const Portal& portal = state.portals[hop.portal];
+        if (hop.to < 0 || !portal.isAvailable(state.turn) || !portal.isColorAllowed(color)) return;
+        int toX = hop.to % size;
+        int toY = hop.to / size;
+        // Neighbouring squares were already generated above.
+        if (std::abs(toX - x) <= 1 && std::abs(toY - y) <= 1) return;
+        addMove(shape, piece, x, y, toX, toY, MOVE_QUIET, moves);
+    };
+    for (const PortalMap::Hop* hop = portalMap.begin(from); hop != portalMap.end(from); ++hop) hopTo(*hop);
+    for (const PortalMap::Hop* hop = portalMap.reverseBegin(from); hop != portalMap.reverseEnd(from); ++hop) {
+        // A portal leading back onto its own entry was handled above.
+        if (hop->to != from) hopTo(*hop);
+    }
+}
+
+template <typename Shape>
+void MoveGenerator::generateRangedAttacks(const Shape& shape, Piece* piece, int x, int y, MoveList& moves) const {
+    if (piece->definition().rules.shotRange == 0) return;
+    const ChessBoard& board = state.board;
+    int from = shape.toSquare(x, y);
+    Scratch& buffers = scratch();
+    buffers.targets.assign(shape.words(), 0);
+    buffers.depends.assign(shape.words(), 0);
+    ranged::markShots(board, piece, from, buffers.targets.data(), buffers.depends.data());
+    for (int word = 0; word < shape.words(); ++word) {
+        for (uint64_t bits = buffers.targets[word]; bits; bits &= bits - 1) {
+            int sq = word * 64 + __builtin_ctzll(bits);
+            Piece* target = board.cellAt(shape.squareToIndex(sq));
+            if (target && target->getColorId() != piece->getColorId()) {
+                moves.push({static_cast<uint16_t>(from), static_cast<uint16_t>(sq),
+                            static_cast<uint8_t>(MOVE_RANGED | MOVE_CAPTURE), 0});
+            }
+        }
+    }
+}
+
+template <typename Shape>
+void MoveGenerator::addMove(const Shape& shape, Piece* piece, int fromX, int fromY, int toX, int toY, uint8_t flags,
+                            MoveList& moves) const {
+    const ChessBoard& board = state.board;
+    int size = shape.size();
+    int color = piece->getColorId();
+    Piece* target = board.getPieceAt(shape, toX, toY);
+    if (target && target->getColorId() == color) return;
+    if (target) flags |= MOVE_CAPTURE;
+
+    int finalY = toY;
+    const Portal* portal = state.portalAt(toX, toY, piece->getColorId());
+    if (portal && portal->isAvailable(state.turn)) {
+        flags |= MOVE_PORTAL;
+        finalY = portal->getExit().y;
+    }
+
+    Move move;
+    move.from = static_cast<uint16_t>(fromY * size + fromX);
+    move.to = static_cast<uint16_t>(toY * size + toX);
+    move.flags = flags;
+
+    int lastRank = (color == WHITE) ? size - 1 : 0;
+    if (finalY == lastRank && piece->hasAbility(ABILITY_PROMOTION)) {
+        bool promoted = false;
+        for (Piece* candidate : state.getPromotionPieces()) {
+            if (candidate->getColorId() != color) continue;
+            move.flags = flags | MOVE_PROMOTION;
+            move.promotion = static_cast<uint8_t>(candidate->getTypeId());
+            moves.push(move);
+            promoted = true;
+        }
+        if (promoted) return;
+        move.flags = flags;
+        move.promotion = 0;
+    }
+    moves.push(move);
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include <vector>
+#include "GameState.h"
+#include "Move.h"
+
+// Lists every move of one side in a single pass over its pieces, using
+// the same rules as MoveValidator::validateMove (direct slides and leaps,
+// BFS reachability through empty squares and portals, pawn pushes and
+// captures, king portal hops, PieceBehavior rules) plus en passant,
+// promotion and ranged attacks. Moves onto a square held by the mover's
+// own color are never generated.
+class MoveGenerator {
+public:
+    explicit MoveGenerator(const GameState& state);
+
+    void generatePseudoLegalMoves(int color, MoveList& moves) const;
+
+    // Pseudo-legal moves that do not leave the mover's king attacked,
+    // filtered through CheckInfo's checker, pin and evasion masks.
+    void generateMoves(int color, MoveList& moves) const;
+
+    // Whether the side has any legal move; stops at the first one.
+    bool hasLegalMove(int color) const;
+
+    // Plays the move out on a copy of the state; for a single move.
+    bool isLegal(const Move& move) const;
+
+    // The generated move for a from/to pair the validator accepted, so that
+    // en passant, portal and promotion handling follow GameState's rules.
+    // Pawns promote to a Queen when one is available.
+    Move moveFor(Piece* piece, int fromX, int fromY, int toX, int toY, bool ranged) const;
+
+private:
+    const GameState& state;
+
+    // Run on the board's BoardShape, picked once per generate call.
+    template <typename Shape>
+    void generatePieceMoves(const Shape& shape, Piece* piece, int x, int y, MoveList& moves) const;
+    // Squares a piece moving by its MoveRules steps reaches.
+    template <typename Shape>
+    void generateStepTargets(const Shape& shape, Piece* piece, int x, int y, std::vector<uint64_t>& targets) const;
+    template <typename Shape>
+    void generatePawnMoves(const Shape& shape, Piece* piece, int x, int y, MoveList& moves) const;
+    template <typename Shape>
+    void generateKingMoves(const Shape& shape, Piece* piece, int x, int y, MoveList& moves) const;
+    template <typename Shape>
+    void generateRangedAttacks(const Shape& shape, Piece* piece, int x, int y, MoveList& moves) const;
+    template <typename Shape>
+    void addMove(const Shape& shape, Piece* piece, int fromX, int fromY, int toX, int toY, uint8_t flags,
+                 MoveList& moves) const;
+};
@@ -0,0 +1,52 @@
+#include "MoveRules.h"
+#include "PieceDefinition.h"
+
+namespace {
+const StepOffset KNIGHT_LEAPS[8] = {{2, 1}, {1, 2}, {-1, 2}, {-2, 1}, {-2, -1}, {-1, -2}, {1, -2}, {2, -1}};
+}
+
+MoveRules MoveRules::compile(const std::string& type, const PieceMovement& movement, uint32_t abilities) {
+    MoveRules rules;
+    if (type == "Pawn") rules.kernel = MoveKernel::PAWN;
+    else if (type == "King") rules.kernel = MoveKernel::KING;
+    rules.behavior = behaviorFor(type);
+    if (rules.behavior.index() != 0) rules.kernel = MoveKernel::CUSTOM;
+
+    int orthogonal = movement.orthogonalRange();
+    int diagonal = movement.diagonalRange();
+    for (int dir = 0; dir < 8; ++dir) rules.rayRange[dir] = dir < 4 ? orthogonal : diagonal;
+    if (movement.lShape) rules.leaps.assign(KNIGHT_LEAPS, KNIGHT_LEAPS + 8);
+    rules.jumps = (abilities & ABILITY_JUMP_OVER) != 0;
+    rules.captureRange = movement.diagonalCapture;
+    if (orthogonal > 0 || diagonal > 0) rules.stepKinds |= STEP_RAYS;
+    if (!rules.leaps.empty()) rules.stepKinds |= STEP_LEAPS;
+
+    // Only ranged_attack gives a shot; a behavior merely sets its default
+    // reach.
+    int shotRange = 1;
+    int shotMinRange = 1;
+    withBehavior(rules.behavior, [&](const auto& kind) {
+        shotRange = kind.SHOT_RANGE;
+        shotMinRange = kind.SHOT_MIN_RANGE;
+    });
+    if (abilities & ABILITY_RANGED_ATTACK) {
+        rules.shotRange = movement.attackRange > 0 ? movement.attackRange : shotRange;
+        rules.shotMinRange = movement.attackMinRange > 0 ? movement.attackMinRange : shotMinRange;
+        rules.shotLineOfSight = movement.attackLineOfSight;
+    }
+    if (rules.kernel != MoveKernel::STEPS) return rules;
+
+    // Chained steps along a line reach every square a direct slide does,
+    // and a leap step is the direct leap, so those are free fast paths.
+    bool queen = type == "Queen";
+    bool rook = queen || type == "Rook";
+    bool bishop = queen || type == "Bishop";
+    bool knight = type == "Knight";
+    rules.slidesOrthogonally = rook || orthogonal > 0;
+    rules.slidesDiagonally = bishop || diagonal > 0;
+    rules.leapsLikeKnight = knight || movement.lShape;
+    rules.extraOrthogonal = rook && orthogonal == 0;
+    rules.extraDiagonal = bishop && diagonal == 0;
+    rules.extraKnightLeap = knight && !movement.lShape;
+    return rules;
+}
@@ -0,0 +1,64 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "PieceBehavior.h"
+
+struct PieceMovement;
+
+// How the validator, the move generator and the attack map treat a type:
+// pawns and kings keep their own rules, types with a PieceBehavior follow
+// it, and every other type moves by its compiled steps.
+enum class MoveKernel : uint8_t { STEPS, PAWN, KING, CUSTOM };
+
+// Kinds of configured step the reach search tries from each square; every
+// combination runs its own search kernel.
+enum StepKinds : uint8_t { STEP_RAYS = 1, STEP_LEAPS = 2 };
+
+struct StepOffset {
+    int dx;
+    int dy;
+};
+
+// A piece type's movement and special abilities compiled into a
+// descriptor when the type is defined, so that nothing on the move paths
+// compares type names or re-reads the movement:
+//   - the steps the reach search takes: a range along each of the eight
+//     rays (direction::DX/DY order), leaper offsets and whether rays jump
+//     over pieces;
+//   - capture-only steps (diagonal_capture): up to captureRange squares
+//     along the two forward diagonals, taken from the piece's own square
+//     onto the first occupied one;
+//   - ranged attacks (ranged_attack): shots onto enemy pieces from
+//     shotMinRange to shotRange squares away along the eight rays, over
+//     whatever stands in between or, with shotLineOfSight, only up to the
+//     first occupied square;
+//   - the direct slides and knight leap validateMove tries before the
+//     search. Queen, Rook, Bishop and Knight always have theirs; any other
+//     type gets the ones its steps already imply, so a custom piece takes
+//     the same fast paths as a standard one without changing what it can
+//     reach.
+struct MoveRules {
+    MoveKernel kernel = MoveKernel::STEPS;
+    PieceBehavior behavior;  // set for the CUSTOM kernel
+
+    int rayRange[8] = {};
+    std::vector<StepOffset> leaps;
+    bool jumps = false;
+    uint8_t stepKinds = 0;
+    int captureRange = 0;
+    int shotRange = 0;  // 0 when the type cannot shoot
+    int shotMinRange = 0;
+    bool shotLineOfSight = false;
+
+    bool slidesOrthogonally = false;
+    bool slidesDiagonally = false;
+    bool leapsLikeKnight = false;
+    // The direct moves the steps do not give, which the generator and the
+    // attack map add to what the search finds.
+    bool extraOrthogonal = false;
+    bool extraDiagonal = false;
+    bool extraKnightLeap = false;
+
+    static MoveRules compile(const std::string& type, const PieceMovement& movement, uint32_t abilities);
+};
@@ -1,49 +1,86 @@
 #include "MoveValidator.h"
-#include "GameManager.h"
+#include "AttackMap.h"
+#include "GameState.h"
+#include "MoveGenerator.h"
+#include "RangedAttacks.h"
+#include "ReachSearch.h"
+#include <algorithm>
 #include <cmath>
-#include <queue>
-#include <set>
 #include <iostream>
 
-MoveValidator::MoveValidator(ChessBoard* b) : board(b) {}
+namespace {
+const int KING_TYPE = Piece::typeIdOf("King");
+const int PAWN_TYPE = Piece::typeIdOf("Pawn");
+}
+
+MoveValidator::MoveValidator(const ChessBoard* b, const PortalMap* portalMap, int turn, const AttackMap* attacks)
+    : board(b), portalMap(portalMap), turn(turn), attacks(attacks) {}
+
+MoveValidator::MoveValidator(const GameState& position)
+    : MoveValidator(&position.board, &position.getPortalMap(), position.turn, position.getAttackMap()) {}
 
 bool MoveValidator::isValidLinearMove(int fromX, int fromY, int toX, int toY) const {
     return (fromX == toX || fromY == toY || abs(fromX - toX) == abs(fromY - toY));
 }
 
 bool MoveValidator::isPathClear(int fromX, int fromY, int toX, int toY) const {
+    if (board->isValidPosition(fromX, fromY) && board->isValidPosition(toX, toY)) {
+        int size = board->getSize();
+        bool clear = false;
+        if (board->withBitboards([&](const auto& pos) {
+                clear = pos.isPathClear(fromY * size + fromX, toY * size + toX);
+            })) {
+            return clear;
+        }
+    }
+
     int dx = (toX - fromX == 0) ? 0 : (toX - fromX) / std::abs(toX - fromX);
     int dy = (toY - fromY == 0) ? 0 : (toY - fromY) / std::abs(toY - fromY);
 
-    int x = fromX + dx;
-    int y = fromY + dy;
+    int step = dx + dy * board->getStride();
+    int target = board->toIndex(toX, toY);
 
-    while (x != toX || y != toY) {
-        if (board->getPieceAt(x, y) != nullptr)
+    for (int index = board->toIndex(fromX, fromY) + step; index != target; index += step) {
+        if (board->cellAt(index) != nullptr)
             return false;
-        x += dx;
-        y += dy;
     }
 
     return true;
 }
 
-bool MoveValidator::isValidEnPassant(Piece* piece, int fromX, int fromY, int toX, int toY, const LastMove& lastMove) const {
-    if (!piece || piece->getType() != "Pawn") {
+bool MoveValidator::slidesTo(SliderKind kind, int fromX, int fromY, int toX, int toY) const {
+    if (board->isValidPosition(fromX, fromY) && board->isValidPosition(toX, toY)) {
+        int size = board->getSize();
+        bool reached = false;
+        if (board->withBitboards([&](const auto& pos) {
+                auto attacked = sliders::attacks(pos, fromY * size + fromX, kind, sliders::UNLIMITED, pos.occupied);
+                reached = attacked.test(toY * size + toX);
+            })) {
+            return reached;
+        }
+    }
+    int dx = toX - fromX;
+    int dy = toY - fromY;
+    bool aligned = kind == ORTHOGONAL ? (dx == 0) != (dy == 0) : (dx != 0 && std::abs(dx) == std::abs(dy));
+    return aligned && isPathClear(fromX, fromY, toX, toY);
+}
+
+bool MoveValidator::isValidEnPassant(const Piece* piece, int fromX, int fromY, int toX, int toY, const LastMove& lastMove) const {
+    if (!piece || piece->getTypeId() != PAWN_TYPE) {
         std::cout << "Not a pawn" << std::endl;
         return false;
     }
 
-    std::string color = piece->getColor();
-    int direction = (color == "white") ? 1 : -1;
+    int direction = (piece->getColorId() == WHITE) ? 1 : -1;
 
     std::cout << "Checking en passant:" << std::endl;
     std::cout << "Last move: " << lastMove.fromX << "," << lastMove.fromY << " -> " 
-              << lastMove.toX << "," << lastMove.toY << " (" << lastMove.pieceType << ")" << std::endl;
+              << lastMove.toX << "," << lastMove.toY << " ("
+              << (lastMove.pieceType >= 0 ? Piece::typeNameOf(lastMove.pieceType) : "") << ")" << std::endl;
     std::cout << "Current move: " << fromX << "," << fromY << " -> " << toX << "," << toY << std::endl;
     std::cout << "Direction: " << direction << std::endl;
 
-    if (lastMove.pieceType != "Pawn") {
+    if (lastMove.pieceType != PAWN_TYPE) {
         std::cout << "Last move was not a pawn" << std::endl;
         return false;
     }
@@ -73,218 +110,154 @@ bool MoveValidator::isValidEnPassant(Piece* piece, int fromX, int fromY, int toX
     return true;
 }
 
-bool MoveValidator::validateMove(Piece* piece, int fromX, int fromY, int toX, int toY, const std::vector<Portal>& portals) const {
+bool MoveValidator::validateMove(const Piece* piece, int fromX, int fromY, int toX, int toY, const std::vector<Portal>& portals) const {
     if (!piece) return false;
-    std::string type = piece->getType();
-    std::string color = piece->getColor();
+    int color = piece->getColorId();
     int dx = toX - fromX;
     int dy = toY - fromY;
     int absDx = std::abs(dx);
     int absDy = std::abs(dy);
     Piece* target = board->getPieceAt(toX, toY);
 
-    if (type == "Pawn") {
-        int direction = (color == "white") ? 1 : -1;
+    const MoveRules& rules = piece->definition().rules;
+    switch (rules.kernel) {
+    case MoveKernel::PAWN: {
+        int direction = (color == WHITE) ? 1 : -1;
         if (dx == 0 && dy == direction && !target) return true;
         if (dx == 0 && dy == 2*direction && !target &&
-            ((color == "white" && fromY == 1) || (color == "black" && fromY == 6)) &&
+            ((color == WHITE && fromY == 1) || (color == BLACK && fromY == board->getSize() - 2)) &&
             !board->getPieceAt(fromX, fromY + direction)) return true;
         if (absDx == 1 && dy == direction) {
-            if (target && target->getColor() != color) return true;
+            if (target && target->getColorId() != color) return true;
             Piece* adjacentPiece = board->getPieceAt(toX, fromY);
-            if (adjacentPiece && adjacentPiece->getType() == "Pawn" && adjacentPiece->getColor() != color) {
+            if (adjacentPiece && adjacentPiece->getTypeId() == PAWN_TYPE && adjacentPiece->getColorId() != color) {
                 return true;
             }
         }
         return false;
     }
-
-    if (type == "King") {
+    case MoveKernel::KING:
         if (absDx <= 1 && absDy <= 1) return true;
-        if (absDx > 1 || absDy > 1) {
-            for (const auto& portal : portals) {
-                if (portal.isAvailable() && portal.isColorAllowed(color)) {
-                    Position entry = portal.getEntry();
-                    Position exit = portal.getExit();
-                    if ((fromX == entry.x && fromY == entry.y && toX == exit.x && toY == exit.y) ||
-                        (fromX == exit.x && fromY == exit.y && toX == entry.x && toY == entry.y)) {
-                        return true;
-                    }
-                }
-            }
-            return false;
-        }
-        return true;
-    }
-    if (type == "Queen") {
-        if ((absDx == absDy || dx == 0 || dy == 0) && isPathClear(fromX, fromY, toX, toY)) return true;
-        return bfsWithPortals(piece, fromX, fromY, toX, toY, portals);
-    }
-    if (type == "Rook") {
-        if ((dx == 0 || dy == 0) && isPathClear(fromX, fromY, toX, toY)) return true;
-        return bfsWithPortals(piece, fromX, fromY, toX, toY, portals);
-    }
-    if (type == "Bishop") {
-        if ((absDx == absDy) && isPathClear(fromX, fromY, toX, toY)) return true;
-        return bfsWithPortals(piece, fromX, fromY, toX, toY, portals);
+        return isPortalHop(color, fromX, fromY, toX, toY, portals);
+    case MoveKernel::CUSTOM: {
+        bool valid = false;
+        withBehavior(rules.behavior, [&](const auto& kind) {
+            valid = kind.movesTo(*board, piece, fromX, fromY, toX, toY);
+        });
+        return valid;
     }
-    if (type == "Knight") {
-        if ((absDx == 2 && absDy == 1) || (absDx == 1 && absDy == 2)) return true;
-        return bfsWithPortals(piece, fromX, fromY, toX, toY, portals);
+    case MoveKernel::STEPS:
+        break;
     }
+    if (rules.slidesOrthogonally && slidesTo(ORTHOGONAL, fromX, fromY, toX, toY)) return true;
+    if (rules.slidesDiagonally && slidesTo(DIAGONAL, fromX, fromY, toX, toY)) return true;
+    if (rules.leapsLikeKnight && ((absDx == 2 && absDy == 1) || (absDx == 1 && absDy == 2))) return true;
     return bfsWithPortals(piece, fromX, fromY, toX, toY, portals);
 }
 
-bool MoveValidator::bfsWithPortals(Piece* piece, int fromX, int fromY, int toX, int toY, const std::vector<Portal>& portals) const {
-    struct Node { int x, y; };
-    std::queue<Node> q;
-    std::set<std::pair<int, int>> visited;
-    q.push({fromX, fromY});
-    visited.insert({fromX, fromY});
-
-    const auto movement = piece->getMovement();
-    std::string color = piece->getColor();
+bool MoveValidator::readsBoard(int typeId) {
+    MoveKernel kernel = PieceDefinition::get(typeId).rules.kernel;
+    return kernel == MoveKernel::STEPS || kernel == MoveKernel::CUSTOM;
+}
 
-    while (!q.empty()) {
-        Node curr = q.front(); q.pop();
-        if (curr.x == toX && curr.y == toY) return true;
+bool MoveValidator::canShoot(const Piece* piece, int fromX, int fromY, int toX, int toY) const {
+    return piece && ranged::canShoot(*board, piece, fromX, fromY, toX, toY);
+}
 
-        std::vector<std::pair<int, int>> directions = {
-            {1,0}, {-1,0}, {0,1}, {0,-1}, {1,1}, {-1,-1}, {1,-1}, {-1,1}
+bool MoveValidator::isPortalHop(int color, int fromX, int fromY, int toX, int toY, const std::vector<Portal>& portals) const {
+    int size = board->getSize();
+    if (portalMap && portalMap->getBoardSize() == size && board->isValidPosition(fromX, fromY) &&
+        board->isValidPosition(toX, toY)) {
+        int from = fromY * size + fromX;
+        int to = toY * size + toX;
+        auto open = [&](const PortalMap::Hop& hop) {
+            return hop.to == to && portals[hop.portal].isAvailable(turn) && portals[hop.portal].isColorAllowed(color);
         };
-        bool canJump = piece->hasAbility("jump_over");
-        for (const auto& dir : directions) {
-            int maxStep = 0;
-            if (dir.first == 0 || dir.second == 0) {
-                if (movement.find("sideways") != movement.end())
-                    maxStep = movement.at("sideways");
-                if (movement.find("forward") != movement.end())
-                    maxStep = std::max(maxStep, movement.at("forward"));
-            } else {
-                if (movement.find("diagonal") != movement.end())
-                    maxStep = movement.at("diagonal");
-            }
-            for (int step = 1; step <= maxStep; ++step) {
-                int nx = curr.x + dir.first * step;
-                int ny = curr.y + dir.second * step;
-                if (!board->isValidPosition(nx, ny)) break;
-                if (!canJump && board->getPieceAt(nx, ny) != nullptr && (nx != toX || ny != toY)) break;
-                if (visited.count({nx, ny}) == 0) {
-                    q.push({nx, ny});
-                    visited.insert({nx, ny});
-                }
-                if (!canJump && board->getPieceAt(nx, ny) != nullptr) break;
-            }
+        for (const PortalMap::Hop* hop = portalMap->begin(from); hop != portalMap->end(from); ++hop) {
+            if (open(*hop)) return true;
         }
-        if (movement.find("l_shape") != movement.end() && movement.at("l_shape")) {
-            std::vector<std::pair<int, int>> l_moves = {
-                {2,1},{1,2},{-1,2},{-2,1},{-2,-1},{-1,-2},{1,-2},{2,-1}
-            };
-            for (const auto& mv : l_moves) {
-                int nx = curr.x + mv.first;
-                int ny = curr.y + mv.second;
-                if (board->isValidPosition(nx, ny) && (board->getPieceAt(nx, ny) == nullptr || (nx == toX && ny == toY))) {
-                    if (visited.count({nx, ny}) == 0) {
-                        q.push({nx, ny});
-                        visited.insert({nx, ny});
-                    }
-                }
-            }
+        for (const PortalMap::Hop* hop = portalMap->reverseBegin(from); hop != portalMap->reverseEnd(from); ++hop) {
+            if (open(*hop)) return true;
         }
-        for (const auto& portal : portals) {
-            if (portal.isAvailable() && portal.isColorAllowed(color)) {
-                Position entry = portal.getEntry();
-                Position exit = portal.getExit();
-                if (curr.x == entry.x && curr.y == entry.y) {
-                    if (visited.count({exit.x, exit.y}) == 0) {
-                        q.push({exit.x, exit.y});
-                        visited.insert({exit.x, exit.y});
-                    }
-                }
+        return false;
+    }
+    for (const auto& portal : portals) {
+        if (portal.isAvailable(turn) && portal.isColorAllowed(color)) {
+            Position entry = portal.getEntry();
+            Position exit = portal.getExit();
+            if ((fromX == entry.x && fromY == entry.y && toX == exit.x && toY == exit.y) ||
+                (fromX == exit.x && fromY == exit.y && toX == entry.x && toY == entry.y)) {
+                return true;
             }
         }
     }
     return false;
 }
 
-bool MoveValidator::isKingInCheck(const std::string& color, const std::vector<Portal>& portals) const {
-    int kingX = -1, kingY = -1;
-    for (int x = 0; x < 8; x++) {
-        for (int y = 0; y < 8; y++) {
-            Piece* piece = board->getPieceAt(x, y);
-            if (piece && piece->getType() == "King" && piece->getColor() == color) {
-                kingX = x;
-                kingY = y;
-                break;
-            }
-        }
-        if (kingX != -1) break;
+bool MoveValidator::bfsWithPortals(const Piece* piece, int fromX, int fromY, int toX, int toY, const std::vector<Portal>& portals) const {
+    if (!board->isValidPosition(fromX, fromY) || !board->isValidPosition(toX, toY)) return false;
+    int size = board->getSize();
+    const ReachTable& steps = reach::table(piece->getTypeId(), size);
+    int from = fromY * size + fromX;
+    int target = toY * size + toX;
+
+    // A single step is a table lookup plus a check for blockers in between.
+    if (steps.hops(from, target) &&
+        (steps.jumps || steps.leaps(from, target) || isPathClear(fromX, fromY, toX, toY))) {
+        return true;
     }
 
-    std::string oppositeColor = (color == "white") ? "black" : "white";
-    for (int x = 0; x < 8; x++) {
-        for (int y = 0; y < 8; y++) {
-            Piece* piece = board->getPieceAt(x, y);
-            if (piece && piece->getColor() == oppositeColor) {
-                if (validateMove(piece, x, y, kingX, kingY, portals)) {
-                    return true;
-                }
-            }
-        }
+    thread_local ReachSearch search;
+    if (portalMap && portalMap->getBoardSize() == size) {
+        return search.reaches(*board, portals, *portalMap, turn, piece, from, target);
     }
-    return false;
+    return search.reaches(*board, portals, PortalMap(portals, size), turn, piece, from, target);
+}
+
+bool MoveValidator::isKingInCheck(int color, const std::vector<Portal>& portals) const {
+    int kingX = -1, kingY = -1;
+    if (!board->findPiece(KING_TYPE, color, kingX, kingY)) return false;
+    return isSquareUnderAttack(kingX, kingY, color == WHITE ? BLACK : WHITE, portals);
+}
+
+bool MoveValidator::isKingInCheck(const std::string& color, const std::vector<Portal>& portals) const {
+    return isKingInCheck(Piece::colorIdOf(color), portals);
 }
 
 std::vector<std::pair<int, int>> MoveValidator::getKingMoves(int kingX, int kingY) const {
     std::vector<std::pair<int, int>> moves;
-    int dx[] = {-1, -1, -1, 0, 0, 1, 1, 1};
-    int dy[] = {-1, 0, 1, -1, 1, -1, 0, 1};
-
-    for (int i = 0; i < 8; i++) {
-        int newX = kingX + dx[i];
-        int newY = kingY + dy[i];
-        if (newX >= 0 && newX < 8 && newY >= 0 && newY < 8) {
-            moves.emplace_back(newX, newY);
-        }
+    for (int dir = 0; dir < direction::COUNT; ++dir) {
+        int newX = kingX + direction::DX[dir];
+        int newY = kingY + direction::DY[dir];
+        if (board->isValidPosition(newX, newY)) moves.emplace_back(newX, newY);
     }
     return moves;
 }
 
-bool MoveValidator::isSquareUnderAttack(int x, int y, const std::string& attackingColor, const std::vector<Portal>& portals) const {
-    for (int i = 0; i < 8; i++) {
-        for (int j = 0; j < 8; j++) {
-            Piece* piece = board->getPieceAt(i, j);
-            if (piece && piece->getColor() == attackingColor) {
-                if (validateMove(piece, i, j, x, y, portals)) {
-                    return true;
-                }
-            }
-        }
+bool MoveValidator::isSquareUnderAttack(int x, int y, int attackingColor, const std::vector<Portal>& portals) const {
+    if (attacks && board->isValidPosition(x, y) && (attackingColor == WHITE || attackingColor == BLACK)) {
+        return attacks->isAttacked(y * board->getSize() + x, attackingColor);
     }
-    return false;
+    bool attacked = false;
+    board->forEachPiece(attackingColor, [&](Piece* piece, int i, int j) {
+        if (!attacked && (validateMove(piece, i, j, x, y, portals) || ranged::covers(*board, piece, i, j, x, y))) {
+            attacked = true;
+        }
+    });
+    return attacked;
 }
 
-bool MoveValidator::canKingEscape(const std::string& color, const std::vector<Portal>& portals) const {
+bool MoveValidator::canKingEscape(int color, const std::vector<Portal>& portals) const {
     int kingX = -1, kingY = -1;
-    for (int x = 0; x < 8; x++) {
-        for (int y = 0; y < 8; y++) {
-            Piece* piece = board->getPieceAt(x, y);
-            if (piece && piece->getType() == "King" && piece->getColor() == color) {
-                kingX = x;
-                kingY = y;
-                break;
-            }
-        }
-        if (kingX != -1) break;
-    }
+    if (!board->findPiece(KING_TYPE, color, kingX, kingY)) return false;
 
-    std::string oppositeColor = (color == "white") ? "black" : "white";
+    int oppositeColor = color == WHITE ? BLACK : WHITE;
     for (const auto& move : getKingMoves(kingX, kingY)) {
         int newX = move.first;
         int newY = move.second;
         Piece* targetPiece = board->getPieceAt(newX, newY);
 
-        if ((!targetPiece || targetPiece->getColor() != color) && 
+        if ((!targetPiece || targetPiece->getColorId() != color) &&
             !isSquareUnderAttack(newX, newY, oppositeColor, portals)) {
             return true;
         }
@@ -292,75 +265,28 @@ bool MoveValidator::canKingEscape(const std::string& color, const std::vector<Po
     return false;
 }
 
-bool MoveValidator::canPieceBlockCheck(const std::string& color, const std::vector<Portal>& portals) const {
-    for (int x = 0; x < 8; x++) {
-        for (int y = 0; y < 8; y++) {
-            Piece* piece = board->getPieceAt(x, y);
-            if (piece && piece->getColor() == color) {
-                for (int newX = 0; newX < 8; newX++) {
-                    for (int newY = 0; newY < 8; newY++) {
-                        if (validateMove(piece, x, y, newX, newY, portals)) {
-                            Piece* capturedPiece = board->getPieceAt(newX, newY);
-                            board->placePiece(newX, newY, piece);
-                            board->removePiece(x, y);
-
-                            bool stillInCheck = isKingInCheck(color, portals);
-
-                            board->placePiece(x, y, piece);
-                            if (capturedPiece) {
-                                board->placePiece(newX, newY, capturedPiece);
-                            } else {
-                                board->removePiece(newX, newY);
-                            }
-
-                            if (!stillInCheck) {
-                                return true;
-                            }
-                        }
-                    }
-                }
-            }
-        }
-    }
-    return false;
+bool MoveValidator::canPieceBlockCheck(int color, const std::vector<Portal>& portals) const {
+    GameState trial(*board, portals);
+    trial.turn = turn;
+    return MoveGenerator(trial).hasLegalMove(color);
+}
+
+bool MoveValidator::isCheckmate(int color, const std::vector<Portal>& portals) const {
+    // One legal move generation settles most positions; the square-by-square
+    // escape test only runs when it finds nothing.
+    return isKingInCheck(color, portals) && !canPieceBlockCheck(color, portals) && !canKingEscape(color, portals);
 }
 
 bool MoveValidator::isCheckmate(const std::string& color, const std::vector<Portal>& portals) const {
-    return isKingInCheck(color, portals) && !canKingEscape(color, portals) && !canPieceBlockCheck(color, portals);
+    return isCheckmate(Piece::colorIdOf(color), portals);
 }
 
 bool MoveValidator::isGameOver(const std::vector<Portal>& portals) const {
-    bool whiteKingExists = false;
-    bool blackKingExists = false;
-    
-    for (const auto& piece : board->getAllPieces()) {
-        if (piece->getType() == "King") {
-            if (piece->getColor() == "white") {
-                whiteKingExists = true;
-            } else {
-                blackKingExists = true;
-            }
-        }
-    }
-    
-    return !whiteKingExists || !blackKingExists;
+    return board->royalCount(WHITE) == 0 || board->royalCount(BLACK) == 0;
 }
 
 std::string MoveValidator::getWinner(const std::vector<Portal>& portals) const {
-    bool whiteKingExists = false;
-    bool blackKingExists = false;
-    
-    for (const auto& piece : board->getAllPieces()) {
-        if (piece->getType() == "King") {
-            if (piece->getColor() == "white") {
-                whiteKingExists = true;
-            } else {
-                blackKingExists = true;
-            }
-        }
-    }
-    
-    if (!whiteKingExists) return "black";
-    if (!blackKingExists) return "white";
+    if (board->royalCount(WHITE) == 0) return "black";
+    if (board->royalCount(BLACK) == 0) return "white";
     return "draw";
 }
\ No newline at end of file
@@ -1,32 +1,67 @@
 #pragma once
 #include "ChessBoard.h"
+#include "Move.h"
 #include "Piece.h"
 #include "Portal.h"
+#include "PortalMap.h"
+#include "SliderAttacks.h"
+#include <string>
 #include <vector>
-#include <queue>
-#include <set>
-#include <unordered_map>
 
-struct LastMove;
+class AttackMap;
+class GameState;
 
+// Answers rule questions about one position: whether a piece may move
+// somewhere, whether a king is attacked or mated. Every query is const and
+// only reads the position it was built over; scratch space (BFS queues,
+// trial positions for checkmate) is thread_local or local to the call.
+// So any number of threads may query one validator, or validators over the
+// same position, at once without locking, as long as nothing modifies that
+// position meanwhile. Threads that follow a live game should each query a
+// snapshot (a copy of the GameState) rather than the game itself.
+//
+// The reach tables for the board size are compiled under a lock the first
+// time they are needed; reach::init compiles them up front.
 class MoveValidator {
 private:
-    ChessBoard* board;
+    const ChessBoard* board;
+    const PortalMap* portalMap;
+    int turn;
+    const AttackMap* attacks;
 
 public:
-    MoveValidator(ChessBoard* board);
+    // portalMap, when given, must index the portals passed to the
+    // validating calls; without one it is rebuilt for each portal search.
+    // Portal availability is judged at the given game turn. An attack map
+    // of the same position, when given, answers the attacked-square
+    // questions (check, king escapes) without asking every enemy piece.
+    MoveValidator(const ChessBoard* board, const PortalMap* portalMap = nullptr, int turn = 0,
+                  const AttackMap* attacks = nullptr);
+    // A validator over the whole position: its board, portal index, turn
+    // and, when tracked, its attack map.
+    explicit MoveValidator(const GameState& position);
     bool isValidLinearMove(int fromX, int fromY, int toX, int toY) const;
     bool isPathClear(int fromX, int fromY, int toX, int toY) const;
-    bool validateMove(Piece* piece, int fromX, int fromY, int toX, int toY, const std::vector<Portal>& portals) const;
+    bool validateMove(const Piece* piece, int fromX, int fromY, int toX, int toY, const std::vector<Portal>& portals) const;
+    // Whether validateMove may look at squares other than the two given
+    // for this type: pawns and kings never slide or search.
+    static bool readsBoard(int typeId);
+    // Whether the piece may shoot the piece on the target square with a
+    // ranged attack. Squares a piece could shoot count as attacked.
+    bool canShoot(const Piece* piece, int fromX, int fromY, int toX, int toY) const;
     bool isGameOver(const std::vector<Portal>& portals) const;
     std::string getWinner(const std::vector<Portal>& portals) const;
-    bool isValidEnPassant(Piece* piece, int fromX, int fromY, int toX, int toY, const LastMove& lastMove) const;
-private:
-    bool bfsWithPortals(Piece* piece, int fromX, int fromY, int toX, int toY, const std::vector<Portal>& portals) const;
+    bool isValidEnPassant(const Piece* piece, int fromX, int fromY, int toX, int toY, const LastMove& lastMove) const;
+    bool isKingInCheck(int color, const std::vector<Portal>& portals) const;
     bool isKingInCheck(const std::string& color, const std::vector<Portal>& portals) const;
-    bool canKingEscape(const std::string& color, const std::vector<Portal>& portals) const;
-    bool canPieceBlockCheck(const std::string& color, const std::vector<Portal>& portals) const;
+    bool isCheckmate(int color, const std::vector<Portal>& portals) const;
     bool isCheckmate(const std::string& color, const std::vector<Portal>& portals) const;
+private:
+    bool slidesTo(SliderKind kind, int fromX, int fromY, int toX, int toY) const;
+    bool isPortalHop(int color, int fromX, int fromY, int toX, int toY, const std::vector<Portal>& portals) const;
+    bool bfsWithPortals(const Piece* piece, int fromX, int fromY, int toX, int toY, const std::vector<Portal>& portals) const;
+    bool canKingEscape(int color, const std::vector<Portal>& portals) const;
+    bool canPieceBlockCheck(int color, const std::vector<Portal>& portals) const;
     std::vector<std::pair<int, int>> getKingMoves(int kingX, int kingY) const;
-    bool isSquareUnderAttack(int x, int y, const std::string& attackingColor, const std::vector<Portal>& portals) const;
+    bool isSquareUnderAttack(int x, int y, int attackingColor, const std::vector<Portal>& portals) const;
 };
\ No newline at end of file
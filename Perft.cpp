@@ -0,0 +1,74 @@
+#include "Perft.h"
+#include <chrono>
+#include <vector>
+#include "AllocationCounter.h"
+#include "MoveGenerator.h"
+
+namespace {
+void generate(const GameState& state, PerftMode mode, MoveList& moves) {
+    moves.clear();
+    if (state.isGameOver()) return;
+    MoveGenerator generator(state);
+    if (mode == PerftMode::LEGAL) generator.generateMoves(state.sideToMove, moves);
+    else generator.generatePseudoLegalMoves(state.sideToMove, moves);
+}
+
+// One move list per ply, allocated once for the whole run.
+uint64_t countNodes(GameState& state, int depth, PerftMode mode, std::vector<MoveList>& lists) {
+    if (depth == 0) return 1;
+    MoveList& moves = lists[depth];
+    generate(state, mode, moves);
+    if (depth == 1) return moves.size();
+
+    uint64_t nodes = 0;
+    for (const Move& move : moves) {
+        state.makeMove(move);
+        nodes += countNodes(state, depth - 1, mode, lists);
+        state.unmakeMove();
+    }
+    return nodes;
+}
+}
+
+uint64_t perft(const GameState& state, int depth, PerftMode mode) {
+    // Counting never asks whether a square is attacked, so a tracked
+    // attack map would only slow every make and unmake down.
+    GameState position = state;
+    position.trackAttacks(false);
+    std::vector<MoveList> lists(depth + 1);
+    return countNodes(position, depth, mode, lists);
+}
+
+PerftResult perftDivide(const GameState& state, int depth, PerftMode mode, std::ostream& out) {
+    PerftResult result;
+    if (depth < 1) {
+        result.nodes = 1;
+        out << "Nodes: 1\n";
+        return result;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<MoveList> lists(depth + 1);
+    GameState position = state;
+    position.trackAttacks(false);
+    MoveList rootMoves;
+    generate(position, mode, rootMoves);
+    int size = position.board.getSize();
+    for (const Move& move : rootMoves) {
+        uint64_t allocationsBefore = allocations::count();
+        position.makeMove(move);
+        uint64_t nodes = countNodes(position, depth - 1, mode, lists);
+        position.unmakeMove();
+        result.allocations += allocations::count() - allocationsBefore;
+        out << moveToString(move, size) << ": " << nodes << "\n";
+        result.nodes += nodes;
+    }
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    out << "\nMoves: " << rootMoves.size() << "\n";
+    out << "Nodes: " << result.nodes << "\n";
+    out << "Time: " << static_cast<int64_t>(result.seconds * 1000) << " ms\n";
+    out << "NPS: " << static_cast<int64_t>(result.nodesPerSecond()) << "\n";
+    out << "Allocations: " << result.allocations << "\n";
+    return result;
+}
@@ -0,0 +1,27 @@
+#pragma once
+#include <cstdint>
+#include <ostream>
+#include "GameState.h"
+
+// Pseudo-legal perft follows the REPL rules: any generated move may be
+// played and a game ends when a king is captured. Legal perft only plays
+// moves that do not leave the mover's king attacked.
+enum class PerftMode { PSEUDO_LEGAL, LEGAL };
+
+struct PerftResult {
+    uint64_t nodes = 0;
+    double seconds = 0.0;
+    // Heap allocations made while walking the tree below the root moves;
+    // zero once move generation and make/unmake are allocation-free.
+    uint64_t allocations = 0;
+
+    double nodesPerSecond() const { return seconds > 0.0 ? nodes / seconds : 0.0; }
+};
+
+// Number of leaf positions reachable from the state in exactly `depth`
+// plies, with the state's side to move playing first.
+uint64_t perft(const GameState& state, int depth, PerftMode mode = PerftMode::PSEUDO_LEGAL);
+
+// Prints the subtree count of every root move ("divide"), then the total
+// and the throughput.
+PerftResult perftDivide(const GameState& state, int depth, PerftMode mode, std::ostream& out);
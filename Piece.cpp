@@ -1,28 +1,66 @@
 #include "Piece.h"
+#include <unordered_map>
+#include <vector>
+
+Piece::Piece(int typeId, int colorId)
+    : typeId(static_cast<uint16_t>(typeId)), colorId(static_cast<uint8_t>(colorId)) {}
 
 Piece::Piece(const std::string& type,
              const std::string& color,
              const std::map<std::string, int>& movement,
              const std::map<std::string, bool>& abilities)
-    : type(type), color(color), movement(movement), specialAbilities(abilities) {}
+    : Piece(PieceDefinition::define(type, movement, abilities), colorIdOf(color)) {}
 
-std::string Piece::getType() const {
-    return type;
+const std::string& Piece::getType() const {
+    return typeNameOf(typeId);
 }
 
-std::string Piece::getColor() const {
-    return color;
+const std::string& Piece::getColor() const {
+    return colorNameOf(colorId);
 }
 
-std::map<std::string, int> Piece::getMovement() const {
-    return movement;
+bool Piece::hasAbility(const std::string& key) const {
+    uint32_t bit = PieceDefinition::findAbilityBit(key);
+    return bit != 0 && definition().has(bit);
 }
 
-std::map<std::string, bool> Piece::getSpecialAbilities() const {
-    return specialAbilities;
+namespace {
+struct TypeNames {
+    std::unordered_map<std::string, int> ids;
+    std::vector<std::string> names;
+};
+
+TypeNames& typeNames() {
+    static TypeNames registry;
+    return registry;
+}
 }
 
-bool Piece::hasAbility(const std::string& key) const {
-    auto it = specialAbilities.find(key);
-    return it != specialAbilities.end() && it->second;
+int Piece::typeIdOf(const std::string& type) {
+    TypeNames& registry = typeNames();
+    auto it = registry.ids.find(type);
+    if (it != registry.ids.end()) return it->second;
+    int id = static_cast<int>(registry.names.size());
+    registry.ids.emplace(type, id);
+    registry.names.push_back(type);
+    return id;
+}
+
+const std::string& Piece::typeNameOf(int typeId) {
+    return typeNames().names.at(typeId);
+}
+
+int Piece::typeCount() {
+    return static_cast<int>(typeNames().names.size());
+}
+
+int Piece::colorIdOf(const std::string& color) {
+    if (color == "white") return WHITE;
+    if (color == "black") return BLACK;
+    return NO_COLOR;
+}
+
+const std::string& Piece::colorNameOf(int colorId) {
+    static const std::string names[] = {"white", "black", ""};
+    return names[colorId >= WHITE && colorId <= BLACK ? colorId : NO_COLOR];
 }
\ No newline at end of file
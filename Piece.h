@@ -1,26 +1,46 @@
 #pragma once
+#include <cstdint>
 #include <string>
 #include <map>
+#include "PieceDefinition.h"
 
+enum PieceColor { WHITE = 0, BLACK = 1, NO_COLOR = 2 };
+
+// A piece on the board: the id of its shared PieceDefinition (which is
+// also its type id) and its color.
 class Piece {
 private:
-    std::string type;
-    std::string color;
-
-    std::map<std::string, int> movement;
-
-    std::map<std::string, bool> specialAbilities;
+    uint16_t typeId;
+    uint8_t colorId;
 
 public:
+    // Upper bound on distinct piece type names; ids at or above it are not
+    // tracked in the board's per-type occupancy masks.
+    static constexpr int MAX_TYPES = 32;
+
+    Piece(int typeId, int colorId);
     Piece(const std::string& type,
           const std::string& color,
           const std::map<std::string, int>& movement,
           const std::map<std::string, bool>& abilities);
 
-    std::string getType() const;
-    std::string getColor() const;
-    std::map<std::string, int> getMovement() const;
-    std::map<std::string, bool> getSpecialAbilities() const;
+    const std::string& getType() const;
+    const std::string& getColor() const;
+    int getTypeId() const { return typeId; }
+    int getColorId() const { return colorId; }
+    const PieceDefinition& definition() const { return PieceDefinition::get(typeId); }
+    const PieceMovement& getMovement() const { return definition().movement; }
 
+    bool hasAbility(uint32_t ability) const { return definition().has(ability); }
     bool hasAbility(const std::string& key) const;
-};
\ No newline at end of file
+
+    // Registry of small dense ids for type names and colors. ConfigReader
+    // registers every configured type at load time; names seen later are
+    // assigned the next id on first use. Registration is not thread-safe,
+    // lookups of registered names are.
+    static int typeIdOf(const std::string& type);
+    static const std::string& typeNameOf(int typeId);
+    static int typeCount();
+    static int colorIdOf(const std::string& color);
+    static const std::string& colorNameOf(int colorId);
+};
@@ -0,0 +1,53 @@
+#include "PieceBehavior.h"
+#include "ChessBoard.h"
+#include "ReachSearch.h"
+#include <algorithm>
+#include <cstdlib>
+
+PieceBehavior behaviorFor(const std::string& type) {
+    if (type == "Archer") return ArcherMoves();
+    return std::monostate();
+}
+
+bool ArcherMoves::movesTo(const ChessBoard& board, const Piece* piece, int fromX, int fromY, int toX, int toY) const {
+    Piece* target = board.getPieceAt(toX, toY);
+    if (!board.isValidPosition(toX, toY) || (target && target->getColorId() == piece->getColorId())) return false;
+
+    int dx = toX - fromX;
+    int dy = toY - fromY;
+    int distance = std::max(std::abs(dx), std::abs(dy));
+    if (distance == 0 || (dx != 0 && dy != 0 && std::abs(dx) != std::abs(dy))) return false;
+    int stepX = (dx > 0) - (dx < 0);
+    int stepY = (dy > 0) - (dy < 0);
+    const MoveRules& rules = piece->definition().rules;
+    int dir = 0;
+    while (direction::DX[dir] != stepX || direction::DY[dir] != stepY) ++dir;
+    if (distance > rules.rayRange[dir]) return false;
+    for (int step = 1; step < distance; ++step) {
+        Piece* between = board.getPieceAt(fromX + stepX * step, fromY + stepY * step);
+        if (between && (!rules.jumps || between->getColorId() != piece->getColorId())) return false;
+    }
+    return true;
+}
+
+void ArcherMoves::markMoves(const ChessBoard& board, const Piece* piece, int x, int y, uint64_t* targets,
+                            uint64_t* depends) const {
+    int size = board.getSize();
+    const MoveRules& rules = piece->definition().rules;
+    for (int dir = 0; dir < direction::COUNT; ++dir) {
+        for (int step = 1; step <= rules.rayRange[dir]; ++step) {
+            int tx = x + direction::DX[dir] * step;
+            int ty = y + direction::DY[dir] * step;
+            if (!board.isValidPosition(tx, ty)) break;
+            int sq = ty * size + tx;
+            setBit(depends, sq);
+            Piece* occupant = board.getPieceAt(tx, ty);
+            if (occupant && occupant->getColorId() == piece->getColorId()) {
+                if (rules.jumps) continue;
+                break;
+            }
+            setBit(targets, sq);
+            if (occupant) break;
+        }
+    }
+}
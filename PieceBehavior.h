@@ -0,0 +1,49 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <variant>
+
+class ChessBoard;
+class Piece;
+
+// Archer's own rules: a single move along a rank, file or diagonal, up
+// to the configured range of that ray (its compiled MoveRules::rayRange).
+// Enemy pieces block the way; pieces of its color do too unless it has
+// jump_over. With ranged_attack and no configured range, it shoots an
+// enemy exactly SHOT_RANGE squares away, whatever stands in between.
+struct ArcherMoves {
+    // The default shot, compiled into MoveRules like a configured one.
+    static constexpr int SHOT_RANGE = 2;
+    static constexpr int SHOT_MIN_RANGE = 2;
+
+    bool movesTo(const ChessBoard& board, const Piece* piece, int fromX, int fromY, int toX, int toY) const;
+    // Sets in `targets` every square the piece on (x, y) can move to, and
+    // in `depends` every square those answers read (size^2 bits each).
+    void markMoves(const ChessBoard& board, const Piece* piece, int x, int y, uint64_t* targets,
+                   uint64_t* depends) const;
+};
+
+// Hand-written rules for piece types whose moves their configured steps
+// cannot express, as a closed set of kinds chosen per type name when the
+// type is defined. A kind is a plain struct with the members ArcherMoves
+// has; callers reach it through withBehavior, which switches on the
+// variant index instead of making a virtual call. std::monostate means
+// the type has no such rules and moves by its MoveRules steps.
+using PieceBehavior = std::variant<std::monostate, ArcherMoves>;
+
+PieceBehavior behaviorFor(const std::string& type);
+
+// Calls fn(kind) with the type's behavior kind and returns true, or
+// returns false for a type without one.
+template <typename Fn>
+bool withBehavior(const PieceBehavior& behavior, Fn&& fn) {
+    return std::visit([&](const auto& kind) {
+        if constexpr (std::is_same_v<std::decay_t<decltype(kind)>, std::monostate>) {
+            return false;
+        } else {
+            fn(kind);
+            return true;
+        }
+    }, behavior);
+}
@@ -0,0 +1,107 @@
+#include "PieceDefinition.h"
+#include "ConfigReader.hpp"
+#include "Piece.h"
+#include <unordered_map>
+#include <vector>
+
+std::vector<PieceDefinition> PieceDefinition::table;
+std::vector<char> PieceDefinition::defined;
+const PieceDefinition PieceDefinition::undefined;
+
+namespace {
+struct AbilityNames {
+    std::unordered_map<std::string, uint32_t> bits;
+    int next = 0;
+
+    AbilityNames() {
+        for (const char* name : {"castling", "royal", "jump_over", "promotion", "en_passant", "ranged_attack"}) {
+            bits.emplace(name, 1u << next++);
+        }
+    }
+};
+
+AbilityNames& abilityNames() {
+    static AbilityNames registry;
+    return registry;
+}
+
+}
+
+int PieceDefinition::store(const std::string& type, const PieceDefinition& definition) {
+    int typeId = Piece::typeIdOf(type);
+    if (typeId >= static_cast<int>(table.size())) {
+        table.resize(typeId + 1);
+        defined.resize(typeId + 1, 0);
+    }
+    table[typeId] = definition;
+    table[typeId].rules = MoveRules::compile(type, definition.movement, definition.abilities);
+    defined[typeId] = 1;
+    return typeId;
+}
+
+int PieceDefinition::define(const PieceConfig& config) {
+    PieceDefinition definition;
+    definition.movement.forward = config.movement.forward;
+    definition.movement.sideways = config.movement.sideways;
+    definition.movement.diagonal = config.movement.diagonal;
+    definition.movement.lShape = config.movement.l_shape;
+    definition.movement.diagonalCapture = config.movement.diagonal_capture;
+    definition.movement.attackRange = config.movement.attack_range;
+    definition.movement.attackMinRange = config.movement.attack_min_range;
+    definition.movement.attackLineOfSight = config.movement.attack_line_of_sight;
+
+    const auto& abilities = config.special_abilities;
+    for (const auto& [name, enabled] : abilities.custom_abilities) {
+        if (enabled) definition.abilities |= abilityBit(name);
+    }
+    if (abilities.castling) definition.abilities |= ABILITY_CASTLING;
+    if (abilities.royal) definition.abilities |= ABILITY_ROYAL;
+    if (abilities.jump_over) definition.abilities |= ABILITY_JUMP_OVER;
+    if (abilities.promotion) definition.abilities |= ABILITY_PROMOTION;
+    if (abilities.en_passant) definition.abilities |= ABILITY_EN_PASSANT;
+    return store(config.type, definition);
+}
+
+int PieceDefinition::define(const std::string& type, const std::map<std::string, int>& movement,
+                            const std::map<std::string, bool>& abilities) {
+    int typeId = Piece::typeIdOf(type);
+    if (isDefined(typeId)) return typeId;
+
+    PieceDefinition definition;
+    auto value = [&](const char* key, int fallback) {
+        auto it = movement.find(key);
+        return it != movement.end() ? it->second : fallback;
+    };
+    definition.movement.forward = value("forward", 0);
+    definition.movement.sideways = value("sideways", 0);
+    definition.movement.diagonal = value("diagonal", 0);
+    definition.movement.lShape = value("l_shape", 0) != 0;
+    definition.movement.diagonalCapture = value("diagonal_capture", 0);
+    definition.movement.attackRange = value("attack_range", 0);
+    definition.movement.attackMinRange = value("attack_min_range", 0);
+    definition.movement.attackLineOfSight = value("attack_line_of_sight", 0) != 0;
+    for (const auto& [name, enabled] : abilities) {
+        if (enabled) definition.abilities |= abilityBit(name);
+    }
+    return store(type, definition);
+}
+
+bool PieceDefinition::isDefined(int typeId) {
+    return typeId >= 0 && typeId < static_cast<int>(defined.size()) && defined[typeId];
+}
+
+uint32_t PieceDefinition::abilityBit(const std::string& name) {
+    AbilityNames& registry = abilityNames();
+    auto it = registry.bits.find(name);
+    if (it != registry.bits.end()) return it->second;
+    if (registry.next >= 32) return 0;
+    uint32_t bit = 1u << registry.next++;
+    registry.bits.emplace(name, bit);
+    return bit;
+}
+
+uint32_t PieceDefinition::findAbilityBit(const std::string& name) {
+    const AbilityNames& registry = abilityNames();
+    auto it = registry.bits.find(name);
+    return it != registry.bits.end() ? it->second : 0;
+}
@@ -0,0 +1,73 @@
+#pragma once
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+#include "MoveRules.h"
+
+struct PieceConfig;
+
+// Bits of PieceDefinition::abilities. Abilities named only in a config's
+// custom_abilities get the next free bit on first use.
+enum Ability : uint32_t {
+    ABILITY_CASTLING = 1u << 0,
+    ABILITY_ROYAL = 1u << 1,
+    ABILITY_JUMP_OVER = 1u << 2,
+    ABILITY_PROMOTION = 1u << 3,
+    ABILITY_EN_PASSANT = 1u << 4,
+    ABILITY_RANGED_ATTACK = 1u << 5
+};
+
+struct PieceMovement {
+    int forward = 0;
+    int sideways = 0;
+    int diagonal = 0;
+    bool lShape = false;
+    int diagonalCapture = 0;
+    // Ranged attacks; 0 leaves the type's default range, which is 1 unless
+    // a PieceBehavior sets its own.
+    int attackRange = 0;
+    int attackMinRange = 0;
+    bool attackLineOfSight = false;
+
+    // Reach of one BFS step along a rank or file, and along a diagonal.
+    int orthogonalRange() const { return forward > sideways ? forward : sideways; }
+    int diagonalRange() const { return diagonal; }
+};
+
+// Immutable rules of one piece type, shared by every piece of that type.
+// Definitions are indexed by the type id from Piece::typeIdOf and are
+// built when a config is loaded; they must not be redefined while a game
+// is running.
+struct PieceDefinition {
+    PieceMovement movement;
+    uint32_t abilities = 0;
+    // Compiled from the two above when the type is defined.
+    MoveRules rules;
+
+    bool has(uint32_t ability) const { return (abilities & ability) != 0; }
+
+    static int define(const PieceConfig& config);
+    // Used by pieces built from movement/ability maps; a type that is
+    // already defined keeps its definition.
+    static int define(const std::string& type, const std::map<std::string, int>& movement,
+                      const std::map<std::string, bool>& abilities);
+    static bool isDefined(int typeId);
+    // Types that were never defined have no movement and no abilities.
+    static const PieceDefinition& get(int typeId) {
+        return static_cast<size_t>(typeId) < table.size() ? table[typeId] : undefined;
+    }
+
+    // Bit for an ability name, assigning one if needed; 0 once all 32 bits
+    // are taken.
+    static uint32_t abilityBit(const std::string& name);
+    // Bit for an ability name, or 0 if no definition has used it.
+    static uint32_t findAbilityBit(const std::string& name);
+
+private:
+    static std::vector<PieceDefinition> table;
+    static std::vector<char> defined;
+    static const PieceDefinition undefined;
+
+    static int store(const std::string& type, const PieceDefinition& definition);
+};
@@ -1,29 +1,20 @@
 #include "Portal.h"
+#include "Piece.h"
 
 Portal::Portal(std::string id, Position entry, Position exit,
                bool preserveDirection, std::vector<std::string> allowedColors, int cooldown)
-    : id(id), entry(entry), exit(exit), preserveDirection(preserveDirection),
-      allowedColors(allowedColors), cooldown(cooldown) {}
-
-bool Portal::isAvailable() const {
-    return currentCooldown == 0;
-}
-
-void Portal::startCooldown() {
-    currentCooldown = cooldown;
-}
-
-void Portal::decrementCooldown() {
-    if (currentCooldown > 0) currentCooldown--;
+    : id(id), entry(entry), exit(exit), preserveDirection(preserveDirection), cooldown(cooldown) {
+    for (const auto& color : allowedColors) {
+        int colorId = Piece::colorIdOf(color);
+        if (colorId != NO_COLOR) colorMask |= 1u << colorId;
+    }
 }
 
 bool Portal::isColorAllowed(const std::string& color) const {
-    for (const auto& allowed : allowedColors) {
-        if (allowed == color) return true;
-    }
-    return false;
+    int colorId = Piece::colorIdOf(color);
+    return colorId != NO_COLOR && isColorAllowed(colorId);
 }
 
 Position Portal::getEntry() const { return entry; }
 Position Portal::getExit() const { return exit; }
-std::string Portal::getId() const { return id; }
\ No newline at end of file
+std::string Portal::getId() const { return id; }
@@ -3,26 +3,34 @@
 #include <vector>
 #include "Position.h"
 
+// A one-way link from an entry square to an exit square. Cooldowns are
+// kept as the game turn at which the portal opens again, so the passing
+// of a turn never touches the portals; the game's turn counter is passed
+// in wherever availability matters.
 class Portal {
 private:
     std::string id;
     Position entry;
     Position exit;
     bool preserveDirection;
-    std::vector<std::string> allowedColors;
     int cooldown;
-    int currentCooldown = 0;
+    int availableAt = 0;     // first turn the portal can be used again
+    unsigned colorMask = 0;  // bit per allowed color id
 
 public:
     Portal(std::string id, Position entry, Position exit,
            bool preserveDirection, std::vector<std::string> allowedColors, int cooldown);
 
-    bool isAvailable() const;
-    void startCooldown();
-    void decrementCooldown();
+    bool isAvailable(int turn) const { return turn >= availableAt; }
+    // Turns left until the portal opens, 0 when it is open.
+    int cooldownRemaining(int turn) const { return availableAt > turn ? availableAt - turn : 0; }
+    void startCooldown(int turn) { availableAt = turn + cooldown; }
+    int getAvailableAt() const { return availableAt; }
+    void setAvailableAt(int turn) { availableAt = turn; }
     bool isColorAllowed(const std::string& color) const;
+    bool isColorAllowed(int colorId) const { return (colorMask >> colorId) & 1u; }
 
     Position getEntry() const;
     Position getExit() const;
     std::string getId() const;
-};
\ No newline at end of file
+};
@@ -0,0 +1,30 @@
+#include "PortalMap.h"
+
+namespace {
+int squareOf(Position p, int boardSize) {
+    bool onBoard = p.x >= 0 && p.x < boardSize && p.y >= 0 && p.y < boardSize;
+    return onBoard ? p.y * boardSize + p.x : -1;
+}
+}
+
+PortalMap::PortalMap(const std::vector<Portal>& portals, int boardSize) : boardSize(boardSize) {
+    // Counting sort by square keeps config order within a square.
+    auto build = [&](Index& index, bool byExit) {
+        index.start.assign(static_cast<size_t>(boardSize) * boardSize + 1, 0);
+        for (const auto& portal : portals) {
+            int sq = squareOf(byExit ? portal.getExit() : portal.getEntry(), boardSize);
+            if (sq >= 0) ++index.start[sq + 1];
+        }
+        for (size_t sq = 1; sq < index.start.size(); ++sq) index.start[sq] += index.start[sq - 1];
+        index.hops.resize(index.start.back());
+        std::vector<uint32_t> next(index.start.begin(), index.start.end() - 1);
+        for (int i = 0; i < static_cast<int>(portals.size()); ++i) {
+            Position from = byExit ? portals[i].getExit() : portals[i].getEntry();
+            Position to = byExit ? portals[i].getEntry() : portals[i].getExit();
+            int sq = squareOf(from, boardSize);
+            if (sq >= 0) index.hops[next[sq]++] = {i, squareOf(to, boardSize)};
+        }
+    };
+    build(entries, false);
+    build(exits, true);
+}
@@ -0,0 +1,41 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "Portal.h"
+
+// The portals of a game indexed by square, so that the portals touching a
+// square are found without scanning every portal. Built once per game:
+// portal squares never change, only cooldowns do, and those are read
+// from the portal itself.
+class PortalMap {
+public:
+    struct Hop {
+        int portal;  // index into the game's portal vector
+        int to;      // square at the other end, or -1 when it is off the board
+    };
+
+    PortalMap() = default;
+    PortalMap(const std::vector<Portal>& portals, int boardSize);
+
+    // Portals whose entry is sq, in config order; `to` is the exit.
+    const Hop* begin(int sq) const { return entries.begin(sq); }
+    const Hop* end(int sq) const { return entries.end(sq); }
+    // Portals whose exit is sq, in config order; `to` is the entry.
+    const Hop* reverseBegin(int sq) const { return exits.begin(sq); }
+    const Hop* reverseEnd(int sq) const { return exits.end(sq); }
+
+    int getBoardSize() const { return boardSize; }
+
+private:
+    struct Index {
+        std::vector<uint32_t> start;  // [sq], one extra entry at the end
+        std::vector<Hop> hops;
+
+        const Hop* begin(int sq) const { return hops.data() + start[sq]; }
+        const Hop* end(int sq) const { return hops.data() + start[sq + 1]; }
+    };
+
+    int boardSize = 0;
+    Index entries;
+    Index exits;
+};
@@ -0,0 +1,46 @@
+#include "RangedAttacks.h"
+#include "ChessBoard.h"
+#include "ReachSearch.h"
+#include <algorithm>
+#include <cstdlib>
+
+bool ranged::covers(const ChessBoard& board, const Piece* piece, int fromX, int fromY, int toX, int toY) {
+    const MoveRules& rules = piece->definition().rules;
+    if (rules.shotRange == 0 || !board.isValidPosition(toX, toY)) return false;
+    int dx = toX - fromX;
+    int dy = toY - fromY;
+    int distance = std::max(std::abs(dx), std::abs(dy));
+    if (distance < rules.shotMinRange || distance > rules.shotRange) return false;
+    if (dx != 0 && dy != 0 && std::abs(dx) != std::abs(dy)) return false;
+    if (!rules.shotLineOfSight) return true;
+    int stepX = (dx > 0) - (dx < 0);
+    int stepY = (dy > 0) - (dy < 0);
+    for (int step = 1; step < distance; ++step) {
+        if (board.getPieceAt(fromX + stepX * step, fromY + stepY * step)) return false;
+    }
+    return true;
+}
+
+bool ranged::canShoot(const ChessBoard& board, const Piece* piece, int fromX, int fromY, int toX, int toY) {
+    if (!covers(board, piece, fromX, fromY, toX, toY)) return false;
+    Piece* target = board.getPieceAt(toX, toY);
+    return target && target->getColorId() != piece->getColorId();
+}
+
+void ranged::markShots(const ChessBoard& board, const Piece* piece, int from, uint64_t* targets, uint64_t* depends) {
+    if (piece->definition().rules.shotRange == 0) return;
+    const ReachTable& table = reach::table(piece->getTypeId(), board.getSize());
+    if (!table.shotLineOfSight) {
+        const uint64_t* mask = table.shotMask(from);
+        for (int w = 0; w < table.words; ++w) targets[w] |= mask[w];
+        return;
+    }
+    for (int dir = 0; dir < direction::COUNT; ++dir) {
+        int step = 1;
+        for (const uint16_t* sq = table.shotBegin(from, dir); sq != table.shotEnd(from, dir); ++sq, ++step) {
+            setBit(depends, *sq);
+            if (step >= table.shotMinRange) setBit(targets, *sq);
+            if (board.cellAt(board.squareToIndex(*sq))) break;
+        }
+    }
+}
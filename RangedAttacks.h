@@ -0,0 +1,28 @@
+#pragma once
+#include <cstdint>
+
+class ChessBoard;
+class Piece;
+
+// Ranged attacks as compiled into a type's MoveRules and laid out in its
+// ReachTable. A shot captures an enemy piece from the minimum to the full
+// shot range away along a rank, file or diagonal without moving the
+// shooter; it flies over anything in between unless it needs a line of
+// sight, in which case the first occupied square stops it. A piece covers
+// the squares it could shoot if an enemy stood there, which is what
+// attack maps and check detection count.
+namespace ranged {
+
+// Whether the piece on (fromX, fromY) covers (toX, toY).
+bool covers(const ChessBoard& board, const Piece* piece, int fromX, int fromY, int toX, int toY);
+
+// Whether the piece can shoot the piece standing on (toX, toY).
+bool canShoot(const ChessBoard& board, const Piece* piece, int fromX, int fromY, int toX, int toY);
+
+// Sets in `targets` every square the piece on `from` covers, and in
+// `depends` the squares that answer reads besides `from` itself: none for
+// shots over the top, the squares each line of sight passes otherwise
+// (size^2 bits each).
+void markShots(const ChessBoard& board, const Piece* piece, int from, uint64_t* targets, uint64_t* depends);
+
+}
@@ -0,0 +1,137 @@
+#include "ReachSearch.h"
+#include <cstdlib>
+
+void ReachSearch::prepare(int squares) {
+    // Every square is queued at most once, so the ring never overflows.
+    uint32_t capacity = 1;
+    while (capacity < static_cast<uint32_t>(squares)) capacity <<= 1;
+    if (ring.size() < capacity) ring.resize(capacity);
+    ringMask = capacity - 1;
+    visited.assign((squares + 63) / 64, 0);
+}
+
+template <bool ALL_TARGETS, bool ROUTE, uint8_t KINDS, typename Shape>
+bool ReachSearch::search(const Shape& shape, const ReachTable& steps, const ChessBoard& board,
+                         const std::vector<Portal>& portals, const PortalMap& portalMap, int turn, const Piece* piece,
+                         int from, int target, uint64_t* targets) {
+    // Fixed shapes keep the queue and the visited set on the stack, where
+    // the set of a board up to 8x8 is a single word.
+    uint16_t fixedQueue[Shape::STACK_SQUARES];
+    uint64_t fixedSeen[Shape::STACK_WORDS] = {};
+    if (!Shape::FIXED) prepare(shape.squares());
+    uint16_t* queue = Shape::FIXED ? fixedQueue : ring.data();
+    uint32_t queueMask = Shape::FIXED ? ~uint32_t(0) : ringMask;
+    uint64_t* seen = Shape::FIXED ? fixedSeen : visited.data();
+    int color = piece->getColorId();
+    uint32_t head = 0;
+    uint32_t tail = 0;
+
+    int current = from;
+    auto occupied = [&](int sq) { return board.cellAt(shape.squareToIndex(sq)) != nullptr; };
+    auto visit = [&](int sq) {
+        if (testBit(seen, sq)) return false;
+        setBit(seen, sq);
+        if (ROUTE) parent[sq] = static_cast<uint16_t>(current);
+        queue[tail++ & queueMask] = static_cast<uint16_t>(sq);
+        return !ALL_TARGETS && sq == target;
+    };
+    // A square that can be moved onto but is not searched from.
+    auto land = [&](int sq) {
+        if (ALL_TARGETS) setBit(targets, sq);
+        if (ROUTE && sq == target) parent[sq] = static_cast<uint16_t>(current);
+        return !ALL_TARGETS && sq == target;
+    };
+
+    if (visit(from)) return true;
+    if (steps.captures && color < NO_COLOR) {
+        for (int side = 0; side < 2; ++side) {
+            for (const uint16_t* sq = steps.captureBegin(color, from, side); sq != steps.captureEnd(color, from, side); ++sq) {
+                if (!occupied(*sq)) continue;
+                if (land(*sq)) return true;
+                break;
+            }
+        }
+    }
+    while (head != tail) {
+        current = queue[head++ & queueMask];
+        if (ALL_TARGETS) setBit(targets, current);
+
+        for (int dir = 0; (KINDS & STEP_RAYS) && dir < direction::COUNT; ++dir) {
+            for (const uint16_t* sq = steps.rayBegin(current, dir); sq != steps.rayEnd(current, dir); ++sq) {
+                if (!steps.jumps && occupied(*sq)) {
+                    if (land(*sq)) return true;
+                    break;
+                }
+                if (visit(*sq)) return true;
+            }
+        }
+        for (const uint16_t* sq = steps.leapBegin(current); (KINDS & STEP_LEAPS) && sq != steps.leapEnd(current); ++sq) {
+            if (occupied(*sq) ? land(*sq) : visit(*sq)) return true;
+        }
+        for (const PortalMap::Hop* hop = portalMap.begin(current); hop != portalMap.end(current); ++hop) {
+            const Portal& portal = portals[hop->portal];
+            if (hop->to >= 0 && portal.isAvailable(turn) && portal.isColorAllowed(color) && visit(hop->to)) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+template <bool ALL_TARGETS, bool ROUTE>
+bool ReachSearch::run(const ChessBoard& board, const std::vector<Portal>& portals, const PortalMap& portalMap, int turn,
+                      const Piece* piece, int from, int target, uint64_t* targets) {
+    const ReachTable& steps = reach::table(piece->getTypeId(), board.getSize());
+    return board.withShape([&](const auto& shape) {
+        switch (steps.stepKinds) {
+            case 0:
+                return search<ALL_TARGETS, ROUTE, 0>(shape, steps, board, portals, portalMap, turn, piece, from, target,
+                                                     targets);
+            case STEP_RAYS:
+                return search<ALL_TARGETS, ROUTE, STEP_RAYS>(shape, steps, board, portals, portalMap, turn, piece, from,
+                                                             target, targets);
+            case STEP_LEAPS:
+                return search<ALL_TARGETS, ROUTE, STEP_LEAPS>(shape, steps, board, portals, portalMap, turn, piece,
+                                                              from, target, targets);
+            default:
+                return search<ALL_TARGETS, ROUTE, STEP_RAYS | STEP_LEAPS>(shape, steps, board, portals, portalMap,
+                                                                          turn, piece, from, target, targets);
+        }
+    });
+}
+
+bool ReachSearch::reaches(const ChessBoard& board, const std::vector<Portal>& portals, const PortalMap& portalMap, int turn,
+                          const Piece* piece, int from, int target) {
+    return run<false, false>(board, portals, portalMap, turn, piece, from, target, nullptr);
+}
+
+void ReachSearch::markReachable(const ChessBoard& board, const std::vector<Portal>& portals,
+                                const PortalMap& portalMap, int turn, const Piece* piece, int from,
+                                std::vector<uint64_t>& targets) {
+    int squares = board.getSize() * board.getSize();
+    if (targets.size() < static_cast<size_t>((squares + 63) / 64)) targets.resize((squares + 63) / 64, 0);
+    run<true, false>(board, portals, portalMap, turn, piece, from, -1, targets.data());
+}
+
+bool ReachSearch::route(const ChessBoard& board, const std::vector<Portal>& portals, const PortalMap& portalMap, int turn,
+                        const Piece* piece, int from, int target, std::vector<uint64_t>& squares) {
+    int size = board.getSize();
+    if (parent.size() < static_cast<size_t>(size * size)) parent.resize(size * size);
+    if (!run<false, true>(board, portals, portalMap, turn, piece, from, target, nullptr)) return false;
+    if (squares.size() < static_cast<size_t>((size * size + 63) / 64)) squares.resize((size * size + 63) / 64, 0);
+
+    setBit(squares.data(), from);
+    for (int sq = target; sq != from; sq = parent[sq]) {
+        setBit(squares.data(), sq);
+        // Squares a slide passed over; for leaps and portal hops that merely
+        // line up this adds squares the route does not need, which is safe.
+        int dx = sq % size - parent[sq] % size;
+        int dy = sq / size - parent[sq] / size;
+        if ((dx == 0) != (dy == 0) || (dx != 0 && std::abs(dx) == std::abs(dy))) {
+            int step = (dy > 0) - (dy < 0);
+            step = step * size + (dx > 0) - (dx < 0);
+            for (int between = parent[sq] + step; between != sq; between += step) setBit(squares.data(), between);
+        }
+    }
+    return true;
+}
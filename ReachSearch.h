@@ -0,0 +1,65 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "ChessBoard.h"
+#include "PortalMap.h"
+#include "ReachTables.h"
+
+// Breadth-first search over a piece's configurable steps (its ReachTable)
+// and the portals open to its color on the given turn: the multi-hop
+// movement validateMove falls back to for anything but a plain slide or
+// leap.
+//
+// Rays stop at the first occupied square unless the piece jumps; an
+// occupied square can be moved onto but is not searched onward, except
+// by jumpers along a ray. Portal exits are always searched onward.
+//
+// The queue is a fixed-capacity ring buffer and visited squares are a
+// bitset, both sized for the board on first use and reused afterwards,
+// so a search does not allocate. Each search runs a kernel instantiated
+// for the board's BoardShape (the common sizes get a compile-time edge
+// and keep both on the stack) and for the kinds of step the piece's
+// MoveRules have, so a pure leaper never walks rays and a pure slider
+// never looks for leaps. Capture-only steps are taken from the starting
+// square alone.
+// One instance must not be used by two
+// threads at once.
+class ReachSearch {
+public:
+    // Whether the piece standing on `from` can reach `target`.
+    bool reaches(const ChessBoard& board, const std::vector<Portal>& portals, const PortalMap& portalMap, int turn,
+                 const Piece* piece, int from, int target);
+
+    // Sets the bit of every square the piece standing on `from` can move
+    // to in `targets` (size^2 bits, 64 per word), in a single traversal.
+    // The starting square itself is included.
+    void markReachable(const ChessBoard& board, const std::vector<Portal>& portals, const PortalMap& portalMap, int turn,
+                       const Piece* piece, int from, std::vector<uint64_t>& targets);
+
+    // Like reaches(), and on success sets in `squares` the bits of one
+    // route from `from` to `target`: the squares it stops on and the
+    // squares its slides pass over. As long as none of them is filled,
+    // the route stays open.
+    bool route(const ChessBoard& board, const std::vector<Portal>& portals, const PortalMap& portalMap, int turn,
+               const Piece* piece, int from, int target, std::vector<uint64_t>& squares);
+
+private:
+    std::vector<uint16_t> ring;
+    uint32_t ringMask = 0;
+    std::vector<uint64_t> visited;
+    std::vector<uint16_t> parent;  // [sq], written only when routing
+
+    void prepare(int squares);
+
+    // Picks the kernel for the board and the piece's steps.
+    template <bool ALL_TARGETS, bool ROUTE>
+    bool run(const ChessBoard& board, const std::vector<Portal>& portals, const PortalMap& portalMap, int turn,
+             const Piece* piece, int from, int target, uint64_t* targets);
+
+    template <bool ALL_TARGETS, bool ROUTE, uint8_t KINDS, typename Shape>
+    bool search(const Shape& shape, const ReachTable& steps, const ChessBoard& board, const std::vector<Portal>& portals,
+                const PortalMap& portalMap, int turn, const Piece* piece, int from, int target, uint64_t* targets);
+};
+
+inline bool testBit(const uint64_t* bits, int sq) { return (bits[sq >> 6] >> (sq & 63)) & 1; }
+inline void setBit(uint64_t* bits, int sq) { bits[sq >> 6] |= uint64_t(1) << (sq & 63); }
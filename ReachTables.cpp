@@ -0,0 +1,148 @@
+#include "ReachTables.h"
+#include "ConfigReader.hpp"
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+namespace {
+
+constexpr int MAX_CACHED_SIZE = 64;
+
+std::unique_ptr<ReachTable> compile(int typeId, int size) {
+    const MoveRules& rules = PieceDefinition::get(typeId).rules;
+    auto table = std::make_unique<ReachTable>();
+    table->size = size;
+    table->jumps = rules.jumps;
+    table->stepKinds = rules.stepKinds;
+    table->captures = rules.captureRange > 0;
+    int squares = size * size;
+    table->words = (squares + 63) / 64;
+    table->hopMask.assign(static_cast<size_t>(squares) * table->words, 0);
+    table->leapMask.assign(static_cast<size_t>(squares) * table->words, 0);
+
+    auto mark = [&](std::vector<uint64_t>& mask, int from, int to) {
+        mask[from * table->words + (to >> 6)] |= uint64_t(1) << (to & 63);
+    };
+    for (int sq = 0; sq < squares; ++sq) {
+        int x = sq % size;
+        int y = sq / size;
+        for (int dir = 0; dir < direction::COUNT; ++dir) {
+            table->rayStart.push_back(static_cast<uint32_t>(table->raySquares.size()));
+            for (int step = 1; step <= rules.rayRange[dir]; ++step) {
+                int nx = x + direction::DX[dir] * step;
+                int ny = y + direction::DY[dir] * step;
+                if (nx < 0 || nx >= size || ny < 0 || ny >= size) break;
+                table->raySquares.push_back(static_cast<uint16_t>(ny * size + nx));
+                mark(table->hopMask, sq, ny * size + nx);
+            }
+        }
+        table->leapStart.push_back(static_cast<uint32_t>(table->leapSquares.size()));
+        for (const StepOffset& leap : rules.leaps) {
+            int nx = x + leap.dx;
+            int ny = y + leap.dy;
+            if (nx < 0 || nx >= size || ny < 0 || ny >= size) continue;
+            table->leapSquares.push_back(static_cast<uint16_t>(ny * size + nx));
+            mark(table->hopMask, sq, ny * size + nx);
+            mark(table->leapMask, sq, ny * size + nx);
+        }
+    }
+    table->rayStart.push_back(static_cast<uint32_t>(table->raySquares.size()));
+    table->leapStart.push_back(static_cast<uint32_t>(table->leapSquares.size()));
+
+    // Forward is up the board for white and down for black.
+    for (int color = 0; color < 2; ++color) {
+        int forward = color == 0 ? 1 : -1;
+        for (int sq = 0; sq < squares; ++sq) {
+            for (int side = -1; side <= 1; side += 2) {
+                table->captureStart.push_back(static_cast<uint32_t>(table->captureSquares.size()));
+                for (int step = 1; step <= rules.captureRange; ++step) {
+                    int nx = sq % size + side * step;
+                    int ny = sq / size + forward * step;
+                    if (nx < 0 || nx >= size || ny < 0 || ny >= size) break;
+                    table->captureSquares.push_back(static_cast<uint16_t>(ny * size + nx));
+                }
+            }
+        }
+    }
+    table->captureStart.push_back(static_cast<uint32_t>(table->captureSquares.size()));
+
+    table->shotRange = rules.shotRange;
+    table->shotMinRange = rules.shotMinRange;
+    table->shotLineOfSight = rules.shotLineOfSight;
+    if (rules.shotRange > 0) {
+        table->shotMasks.assign(static_cast<size_t>(squares) * table->words, 0);
+        for (int sq = 0; sq < squares; ++sq) {
+            for (int dir = 0; dir < direction::COUNT; ++dir) {
+                table->shotStart.push_back(static_cast<uint32_t>(table->shotSquares.size()));
+                for (int step = 1; step <= rules.shotRange; ++step) {
+                    int nx = sq % size + direction::DX[dir] * step;
+                    int ny = sq / size + direction::DY[dir] * step;
+                    if (nx < 0 || nx >= size || ny < 0 || ny >= size) break;
+                    table->shotSquares.push_back(static_cast<uint16_t>(ny * size + nx));
+                    if (step >= rules.shotMinRange) mark(table->shotMasks, sq, ny * size + nx);
+                }
+            }
+        }
+        table->shotStart.push_back(static_cast<uint32_t>(table->shotSquares.size()));
+    }
+    return table;
+}
+
+// Compiled tables are never freed, so a pointer handed out stays valid
+// even after init() replaces the table for its type.
+struct Cache {
+    std::mutex mutex;
+    std::vector<std::unique_ptr<ReachTable>> owned;
+    std::atomic<const ReachTable*> small[Piece::MAX_TYPES][MAX_CACHED_SIZE + 1] = {};
+    std::map<std::pair<int, int>, const ReachTable*> other;
+
+    const ReachTable* store(int typeId, int size, std::unique_ptr<ReachTable> table) {
+        const ReachTable* result = table.get();
+        owned.push_back(std::move(table));
+        if (typeId < Piece::MAX_TYPES && size <= MAX_CACHED_SIZE) {
+            small[typeId][size].store(result, std::memory_order_release);
+        } else {
+            other[{typeId, size}] = result;
+        }
+        return result;
+    }
+};
+
+Cache& cache() {
+    static Cache instance;
+    return instance;
+}
+
+}
+
+void reach::init(const GameConfig& config) {
+    int size = config.game_settings.board_size;
+    Cache& tables = cache();
+    std::lock_guard<std::mutex> lock(tables.mutex);
+    for (const auto* group : {&config.pieces, &config.custom_pieces}) {
+        for (const auto& pieceCfg : *group) {
+            int typeId = Piece::typeIdOf(pieceCfg.type);
+            tables.store(typeId, size, compile(typeId, size));
+        }
+    }
+}
+
+const ReachTable& reach::table(int typeId, int boardSize) {
+    Cache& tables = cache();
+    bool small = typeId < Piece::MAX_TYPES && boardSize <= MAX_CACHED_SIZE;
+    if (small) {
+        const ReachTable* found = tables.small[typeId][boardSize].load(std::memory_order_acquire);
+        if (found) return *found;
+    }
+    std::lock_guard<std::mutex> lock(tables.mutex);
+    if (small) {
+        const ReachTable* found = tables.small[typeId][boardSize].load(std::memory_order_relaxed);
+        if (found) return *found;
+    } else {
+        auto it = tables.other.find({typeId, boardSize});
+        if (it != tables.other.end()) return *it->second;
+    }
+    return *tables.store(typeId, boardSize, compile(typeId, boardSize));
+}
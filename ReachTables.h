@@ -0,0 +1,70 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "BitboardPosition.h"
+
+struct GameConfig;
+
+// Per-square step tables laid out from a type's MoveRules for one board
+// size. They describe a single step of the configurable movement that
+// validateMove searches over: up to the range along each of the eight
+// rays, plus the leaper offsets, and the capture-only rays of each color.
+// Ranged attacks get their own rays and a mask of the squares a shot over
+// the top lands on. Squares are numbered y * size + x.
+struct ReachTable {
+    int size = 0;
+    bool jumps = false;  // jump_over: rays continue past occupied squares
+    uint8_t stepKinds = 0;
+    bool captures = false;
+    int shotRange = 0;
+    int shotMinRange = 0;
+    bool shotLineOfSight = false;
+
+    // Squares along ray `dir` from sq, nearest first, cut at the range.
+    const uint16_t* rayBegin(int sq, int dir) const { return raySquares.data() + rayStart[sq * direction::COUNT + dir]; }
+    const uint16_t* rayEnd(int sq, int dir) const { return raySquares.data() + rayStart[sq * direction::COUNT + dir + 1]; }
+    const uint16_t* leapBegin(int sq) const { return leapSquares.data() + leapStart[sq]; }
+    const uint16_t* leapEnd(int sq) const { return leapSquares.data() + leapStart[sq + 1]; }
+    // Capture-only ray `side` (0 or 1) of a piece of `color` standing on sq.
+    const uint16_t* captureBegin(int color, int sq, int side) const {
+        return captureSquares.data() + captureStart[captureSlot(color, sq, side)];
+    }
+    const uint16_t* captureEnd(int color, int sq, int side) const {
+        return captureSquares.data() + captureStart[captureSlot(color, sq, side) + 1];
+    }
+    // Squares along ray `dir` from sq out to the shot range, nearest first,
+    // including those nearer than the minimum.
+    const uint16_t* shotBegin(int sq, int dir) const { return shotSquares.data() + shotStart[sq * direction::COUNT + dir]; }
+    const uint16_t* shotEnd(int sq, int dir) const { return shotSquares.data() + shotStart[sq * direction::COUNT + dir + 1]; }
+    // Squares a shot from sq lands on when nothing is in the way.
+    const uint64_t* shotMask(int sq) const { return shotMasks.data() + static_cast<size_t>(sq) * words; }
+
+    // Whether `to` is one step from `from` on an empty board.
+    bool hops(int from, int to) const { return (hopMask[from * words + (to >> 6)] >> (to & 63)) & 1; }
+    bool leaps(int from, int to) const { return (leapMask[from * words + (to >> 6)] >> (to & 63)) & 1; }
+
+    std::vector<uint32_t> rayStart;   // [sq * 8 + dir], one extra entry at the end
+    std::vector<uint16_t> raySquares;
+    std::vector<uint32_t> leapStart;  // [sq], one extra entry at the end
+    std::vector<uint16_t> leapSquares;
+    std::vector<uint32_t> captureStart;  // [(color * squares + sq) * 2 + side], one extra at the end
+    std::vector<uint16_t> captureSquares;
+    std::vector<uint32_t> shotStart;  // [sq * 8 + dir], one extra entry at the end; empty without shots
+    std::vector<uint16_t> shotSquares;
+    std::vector<uint64_t> shotMasks;  // [sq * words + w]
+    int words = 0;                    // 64-bit words per square mask
+    std::vector<uint64_t> hopMask;    // [sq * words + w]
+    std::vector<uint64_t> leapMask;
+
+    int captureSlot(int color, int sq, int side) const { return (color * size * size + sq) * 2 + side; }
+};
+
+namespace reach {
+
+// Compiles the tables of every piece type in the config for its board
+// size. Tables for other types or sizes are compiled on first use.
+void init(const GameConfig& config);
+
+const ReachTable& table(int typeId, int boardSize);
+
+}
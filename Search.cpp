@@ -0,0 +1,324 @@
+#include "Search.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include "Evaluation.h"
+#include "MoveGenerator.h"
+
+namespace {
+const Move NO_MOVE{};
+
+// Mate scores are stored relative to the node so they stay valid when the
+// same position is reached at a different ply.
+int toTable(int score, int ply) {
+    if (score >= Search::MATE_SCORE - Search::MAX_PLY) return score + ply;
+    if (score <= -Search::MATE_SCORE + Search::MAX_PLY) return score - ply;
+    return score;
+}
+
+int fromTable(int score, int ply) {
+    if (score >= Search::MATE_SCORE - Search::MAX_PLY) return score - ply;
+    if (score <= -Search::MATE_SCORE + Search::MAX_PLY) return score + ply;
+    return score;
+}
+}
+
+// Per-thread search state. Workers share nothing but the table and the
+// stop flag; only the main worker watches the clock.
+class Search::Worker {
+public:
+    Worker(TranspositionTable& table, std::atomic<bool>& stop)
+        : table(table), stop(stop), moveLists(MAX_PLY + 1), moveScores(MAX_PLY + 1) {
+        for (auto& pair : killers) pair[0] = pair[1] = NO_MOVE;
+    }
+
+    void setDeadline(std::chrono::steady_clock::time_point time) {
+        timed = true;
+        deadline = time;
+    }
+
+    int searchRoot(GameState& position, int depth) {
+        return negamax(position, depth, -INFINITE_SCORE, INFINITE_SCORE, 0);
+    }
+
+    bool stopped() const { return stop.load(std::memory_order_relaxed); }
+    std::vector<Move> principalVariation() const { return std::vector<Move>(pv[0], pv[0] + pvLength[0]); }
+    uint64_t nodeCount() const { return publishedNodes.load(std::memory_order_relaxed); }
+    void publishNodes() { publishedNodes.store(nodes, std::memory_order_relaxed); }
+
+private:
+    TranspositionTable& table;
+    std::atomic<bool>& stop;
+    bool timed = false;
+    std::chrono::steady_clock::time_point deadline;
+    uint64_t nodes = 0;
+    std::atomic<uint64_t> publishedNodes{0};
+
+    Move pv[MAX_PLY + 1][MAX_PLY + 1];
+    int pvLength[MAX_PLY + 1];
+    Move killers[MAX_PLY + 1][2];
+    std::vector<MoveList> moveLists;
+    std::vector<std::vector<int>> moveScores;
+
+    int negamax(GameState& state, int depth, int alpha, int beta, int ply);
+    int quiesce(GameState& state, int alpha, int beta, int ply);
+    int terminalScore(const GameState& state, int ply) const;
+    void scoreMoves(const GameState& state, const MoveList& moves, const Move& ttMove, int ply);
+    void pickMove(int from, int ply);
+    void updatePv(int ply, const Move& move);
+    bool countNode();
+};
+
+Search::Search(TranspositionTable& table, int threads) : table(table), threads(1) {
+    setThreads(threads);
+}
+
+void Search::setThreads(int count) {
+    threads = std::max(1, count);
+}
+
+SearchResult Search::run(const GameState& root, const SearchLimits& limits, std::ostream* info) {
+    auto start = std::chrono::steady_clock::now();
+    bool timed = limits.movetimeMs > 0;
+    int maxDepth = limits.depth > 0 ? std::min(limits.depth, MAX_PLY) : (timed ? MAX_PLY : SearchLimits::DEFAULT_DEPTH);
+    table.newSearch();
+
+    std::atomic<bool> stop{false};
+    std::vector<std::unique_ptr<Worker>> workers;
+    for (int i = 0; i < threads; ++i) workers.emplace_back(new Worker(table, stop));
+    Worker& main = *workers[0];
+    if (timed) main.setDeadline(start + std::chrono::milliseconds(limits.movetimeMs));
+    auto totalNodes = [&]() {
+        uint64_t total = 0;
+        for (const auto& worker : workers) total += worker->nodeCount();
+        return total;
+    };
+
+    // Helpers alternate between starting one ply deeper and in step with
+    // the main thread, so that they fill the table ahead of it.
+    std::vector<std::thread> helpers;
+    for (int i = 1; i < threads; ++i) {
+        helpers.emplace_back([&, i]() {
+            Worker& worker = *workers[i];
+            GameState position = root;
+            position.trackAttacks(false);
+            for (int depth = 1 + i % 2; depth <= maxDepth && !worker.stopped(); ++depth) {
+                worker.searchRoot(position, depth);
+            }
+            worker.publishNodes();
+        });
+    }
+
+    SearchResult result;
+    // The search never asks whether a square is attacked, so keeping the
+    // attack counts current at every node would be wasted work.
+    GameState position = root;
+    position.trackAttacks(false);
+    for (int depth = 1; depth <= maxDepth; ++depth) {
+        int score = main.searchRoot(position, depth);
+        if (main.stopped()) break;
+
+        result.depth = depth;
+        result.score = score;
+        result.pv = main.principalVariation();
+        result.hasMove = !result.pv.empty();
+        if (result.hasMove) result.bestMove = result.pv.front();
+
+        if (info) {
+            main.publishNodes();
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            *info << "info depth " << depth << " score ";
+            if (isMateScore(score)) {
+                int plies = MATE_SCORE - std::abs(score);
+                *info << "mate " << (score > 0 ? (plies + 1) / 2 : -(plies + 1) / 2);
+            } else {
+                *info << "cp " << score;
+            }
+            *info << " nodes " << totalNodes() << " time " << static_cast<int64_t>(seconds * 1000) << " pv";
+            for (const Move& move : result.pv) *info << " [" << moveToString(move, root.board.getSize()) << "]";
+            *info << "\n";
+        }
+        if (!result.hasMove || (isMateScore(score) && MATE_SCORE - std::abs(score) <= depth)) break;
+    }
+
+    stop.store(true);
+    for (auto& helper : helpers) helper.join();
+    main.publishNodes();
+    result.nodes = totalNodes();
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return result;
+}
+
+// Counts a node and reports whether the search has been stopped.
+bool Search::Worker::countNode() {
+    if ((++nodes & 1023) == 0) {
+        publishNodes();
+        if (timed && std::chrono::steady_clock::now() >= deadline) stop.store(true, std::memory_order_relaxed);
+    }
+    return stopped();
+}
+
+// A finished game seen from the side to move: losing the last royal piece
+// is a loss, scored so that quicker wins are preferred.
+int Search::Worker::terminalScore(const GameState& state, int ply) const {
+    if (state.board.royalCount(state.sideToMove) == 0) return -MATE_SCORE + ply;
+    return MATE_SCORE - ply;
+}
+
+void Search::Worker::updatePv(int ply, const Move& move) {
+    pv[ply][ply] = move;
+    for (int i = ply + 1; i < pvLength[ply + 1]; ++i) pv[ply][i] = pv[ply + 1][i];
+    pvLength[ply] = std::max(pvLength[ply + 1], ply + 1);
+}
+
+int Search::Worker::negamax(GameState& state, int depth, int alpha, int beta, int ply) {
+    if (countNode()) return 0;
+    pvLength[ply] = ply;
+    if (state.isGameOver()) return terminalScore(state, ply);
+    if (depth <= 0) return quiesce(state, alpha, beta, ply);
+    if (ply >= MAX_PLY - 1) return eval::evaluate(state);
+
+    // Table cutoffs are taken only off the principal variation, so the PV
+    // is always searched and collected in full.
+    bool pvNode = beta - alpha > 1;
+    uint64_t key = state.hash();
+    Move ttMove;
+    TTEntry entry;
+    if (table.probe(key, entry)) {
+        ttMove = entry.move();
+        if (!pvNode && entry.depth >= depth) {
+            int score = fromTable(entry.score, ply);
+            if (entry.bound() == BOUND_EXACT ||
+                (entry.bound() == BOUND_LOWER && score >= beta) ||
+                (entry.bound() == BOUND_UPPER && score <= alpha)) {
+                return score;
+            }
+        }
+    }
+
+    MoveList& moves = moveLists[ply];
+    moves.clear();
+    MoveGenerator(state).generatePseudoLegalMoves(state.sideToMove, moves);
+    if (moves.empty()) return 0;
+    scoreMoves(state, moves, ttMove, ply);
+
+    int originalAlpha = alpha;
+    int bestScore = -INFINITE_SCORE;
+    Move bestMove;
+    for (int i = 0; i < moves.size(); ++i) {
+        pickMove(i, ply);
+        Move move = moves[i];
+        state.makeMove(move);
+        int score;
+        if (i == 0) {
+            score = -negamax(state, depth - 1, -beta, -alpha, ply + 1);
+        } else {
+            score = -negamax(state, depth - 1, -alpha - 1, -alpha, ply + 1);
+            if (score > alpha && score < beta) score = -negamax(state, depth - 1, -beta, -alpha, ply + 1);
+        }
+        state.unmakeMove();
+        if (stopped()) return 0;
+
+        if (score > bestScore) {
+            bestScore = score;
+            bestMove = move;
+            if (score > alpha) {
+                alpha = score;
+                updatePv(ply, move);
+                if (alpha >= beta) {
+                    if (!move.is(MOVE_CAPTURE) && killers[ply][0] != move) {
+                        killers[ply][1] = killers[ply][0];
+                        killers[ply][0] = move;
+                    }
+                    break;
+                }
+            }
+        }
+    }
+
+    Bound bound = bestScore >= beta ? BOUND_LOWER : (bestScore > originalAlpha ? BOUND_EXACT : BOUND_UPPER);
+    table.store(key, depth, bound, toTable(bestScore, ply), bestMove);
+    return bestScore;
+}
+
+int Search::Worker::quiesce(GameState& state, int alpha, int beta, int ply) {
+    if (countNode()) return 0;
+    pvLength[ply] = ply;
+    if (state.isGameOver()) return terminalScore(state, ply);
+
+    int standPat = eval::evaluate(state);
+    if (ply >= MAX_PLY - 1 || standPat >= beta) return standPat;
+    alpha = std::max(alpha, standPat);
+
+    MoveList& moves = moveLists[ply];
+    moves.clear();
+    MoveGenerator(state).generatePseudoLegalMoves(state.sideToMove, moves);
+    int kept = 0;
+    for (int i = 0; i < moves.size(); ++i) {
+        const Move& move = moves[i];
+        if (move.is(MOVE_CAPTURE) || move.is(MOVE_EN_PASSANT) || move.is(MOVE_PROMOTION)) moves[kept++] = move;
+    }
+    moves.truncate(kept);
+    scoreMoves(state, moves, NO_MOVE, ply);
+
+    for (int i = 0; i < moves.size(); ++i) {
+        pickMove(i, ply);
+        Move move = moves[i];
+        state.makeMove(move);
+        int score = -quiesce(state, -beta, -alpha, ply + 1);
+        state.unmakeMove();
+        if (stopped()) return 0;
+        if (score >= beta) return score;
+        if (score > alpha) {
+            alpha = score;
+            updatePv(ply, move);
+        }
+    }
+    return alpha;
+}
+
+// Table move first, then captures by most valuable victim and least
+// valuable attacker, then killers, then the remaining quiet moves.
+void Search::Worker::scoreMoves(const GameState& state, const MoveList& moves, const Move& ttMove, int ply) {
+    const ChessBoard& board = state.board;
+    int size = board.getSize();
+    std::vector<int>& scores = moveScores[ply];
+    scores.resize(moves.size());
+    for (int i = 0; i < moves.size(); ++i) {
+        const Move& move = moves[i];
+        int score = 0;
+        if (move == ttMove) {
+            score = 1 << 30;
+        } else if (move.is(MOVE_CAPTURE) || move.is(MOVE_EN_PASSANT)) {
+            const Piece* victim = board.getPieceAt(move.to % size, move.to / size);
+            if (move.is(MOVE_EN_PASSANT)) victim = board.getPieceAt(move.to % size, move.from / size);
+            const Piece* attacker = board.getPieceAt(move.from % size, move.from / size);
+            score = (1 << 24) + (victim ? eval::pieceValue(victim) : 0) * 16 - eval::pieceValue(attacker) / 16;
+        } else if (move == killers[ply][0]) {
+            score = 1 << 20;
+        } else if (move == killers[ply][1]) {
+            score = (1 << 20) - 1;
+        }
+        if (move.is(MOVE_PROMOTION)) score += 1 << 22;
+        scores[i] = score;
+    }
+}
+
+// Selection step: swaps the best-scored remaining move into `from`.
+void Search::Worker::pickMove(int from, int ply) {
+    MoveList& moves = moveLists[ply];
+    std::vector<int>& scores = moveScores[ply];
+    int best = from;
+    for (int i = from + 1; i < moves.size(); ++i) {
+        if (scores[i] > scores[best]) best = i;
+    }
+    std::swap(moves[from], moves[best]);
+    std::swap(scores[from], scores[best]);
+}
+
+SearchResult findBestMove(const GameState& root, const SearchLimits& limits, TranspositionTable& table, int threads) {
+    Search search(table, threads);
+    return search.run(root, limits);
+}
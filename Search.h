@@ -0,0 +1,63 @@
+#pragma once
+#include <cstdint>
+#include <ostream>
+#include <vector>
+#include "GameState.h"
+#include "Move.h"
+#include "TranspositionTable.h"
+
+struct SearchLimits {
+    static constexpr int DEFAULT_DEPTH = 5;
+
+    int depth = 0;       // 0: no depth limit
+    int movetimeMs = 0;  // 0: no time limit; with neither set, DEFAULT_DEPTH
+};
+
+struct SearchResult {
+    Move bestMove;
+    bool hasMove = false;
+    int score = 0;
+    int depth = 0;
+    uint64_t nodes = 0;
+    double seconds = 0.0;
+    std::vector<Move> pv;
+};
+
+// Negamax alpha-beta (principal variation search) with iterative
+// deepening over the moves MoveGenerator produces, under the REPL rules:
+// every generated move may be played and capturing the king wins. Leaves
+// are resolved with a capture quiescence search; the transposition table
+// supplies cutoffs and the first move to try at each node.
+//
+// With more than one thread the search runs Lazy SMP: helper threads
+// search their own copy of the root at staggered depths and communicate
+// only through the shared table, while the main thread's iterations
+// decide the result.
+class Search {
+public:
+    static constexpr int MAX_PLY = 64;
+    static constexpr int INFINITE_SCORE = 32000;
+    static constexpr int MATE_SCORE = 30000;
+
+    explicit Search(TranspositionTable& table, int threads = 1);
+
+    void setThreads(int threads);
+    int getThreads() const { return threads; }
+
+    // Searches until the depth limit or the time limit is reached and
+    // returns the result of the last completed iteration. With `info`,
+    // prints one line per iteration.
+    SearchResult run(const GameState& root, const SearchLimits& limits, std::ostream* info = nullptr);
+
+    static bool isMateScore(int score) { return score >= MATE_SCORE - MAX_PLY || score <= -MATE_SCORE + MAX_PLY; }
+
+private:
+    class Worker;
+
+    TranspositionTable& table;
+    int threads;
+};
+
+// Convenience wrapper: a one-off search of `root`.
+SearchResult findBestMove(const GameState& root, const SearchLimits& limits, TranspositionTable& table,
+                          int threads = 1);
@@ -0,0 +1,149 @@
+#include "SliderAttacks.h"
+#include "ConfigReader.hpp"
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <vector>
+#ifdef __BMI2__
+#include <immintrin.h>
+#endif
+
+namespace {
+
+// Ranges of 7 or more reach every edge of an 8x8 board.
+constexpr int FULL_RANGE = 7;
+
+// Per-rank PRNG seeds, tuned offline so the magic search for the full-range
+// tables finishes after few candidates.
+constexpr uint64_t MAGIC_SEEDS[8] = {728, 2985, 786, 2501, 2009, 2821, 1699, 255};
+
+uint64_t walkAttacks(SliderKind kind, int sq, uint64_t occupied, int range, bool relevantOnly) {
+    uint64_t result = 0;
+    int first = kind == ORTHOGONAL ? 0 : 4;
+    for (int dir = first; dir < first + 4; ++dir) {
+        int x = sq % 8;
+        int y = sq / 8;
+        for (int step = 1; step <= range; ++step) {
+            x += direction::DX[dir];
+            y += direction::DY[dir];
+            if (x < 0 || x > 7 || y < 0 || y > 7) break;
+            // The last square of a ray never changes the attack set, so it
+            // is left out of the relevant-occupancy mask.
+            bool last = step == range || x + direction::DX[dir] < 0 || x + direction::DX[dir] > 7 ||
+                        y + direction::DY[dir] < 0 || y + direction::DY[dir] > 7;
+            if (relevantOnly && last) break;
+            uint64_t bit = uint64_t(1) << (y * 8 + x);
+            result |= bit;
+            if (!relevantOnly && (occupied & bit)) break;
+        }
+    }
+    return result;
+}
+
+class MagicTable {
+private:
+    uint64_t masks[64];
+    uint64_t magics[64];
+    int shifts[64];
+    size_t offsets[64];
+    std::vector<uint64_t> table;
+
+    static uint64_t random64(uint64_t& state) {
+        state ^= state >> 12;
+        state ^= state << 25;
+        state ^= state >> 27;
+        return state * 2685821657736338717ULL;
+    }
+
+    size_t index(int sq, uint64_t occupied) const {
+#ifdef __BMI2__
+        return _pext_u64(occupied, masks[sq]);
+#else
+        return static_cast<size_t>(((occupied & masks[sq]) * magics[sq]) >> shifts[sq]);
+#endif
+    }
+
+public:
+    MagicTable(SliderKind kind, int range) {
+        std::vector<uint64_t> occupancies;
+        std::vector<uint64_t> reference;
+        std::vector<int> epoch;
+        for (int sq = 0; sq < 64; ++sq) {
+            masks[sq] = walkAttacks(kind, sq, 0, range, true);
+            int bits = __builtin_popcountll(masks[sq]);
+            size_t entries = size_t(1) << bits;
+            offsets[sq] = table.size();
+            shifts[sq] = bits ? 64 - bits : 63;
+            magics[sq] = 0;
+
+            occupancies.clear();
+            reference.clear();
+            uint64_t subset = 0;
+            do {
+                occupancies.push_back(subset);
+                reference.push_back(walkAttacks(kind, sq, subset, range, false));
+                subset = (subset - masks[sq]) & masks[sq];
+            } while (subset);
+
+            table.resize(table.size() + entries);
+#ifdef __BMI2__
+            for (size_t i = 0; i < occupancies.size(); ++i) {
+                table[offsets[sq] + index(sq, occupancies[i])] = reference[i];
+            }
+#else
+            if (bits == 0) {
+                table[offsets[sq]] = reference[0];
+                continue;
+            }
+            epoch.assign(entries, 0);
+            uint64_t seed = MAGIC_SEEDS[sq / 8];
+            for (int attempt = 1;; ++attempt) {
+                uint64_t candidate = random64(seed) & random64(seed) & random64(seed);
+                if (__builtin_popcountll((masks[sq] * candidate) & 0xFF00000000000000ULL) < 6) continue;
+                magics[sq] = candidate;
+                bool collision = false;
+                for (size_t i = 0; i < occupancies.size() && !collision; ++i) {
+                    size_t slot = index(sq, occupancies[i]);
+                    uint64_t& entry = table[offsets[sq] + slot];
+                    if (epoch[slot] != attempt) {
+                        epoch[slot] = attempt;
+                        entry = reference[i];
+                    } else if (entry != reference[i]) {
+                        collision = true;
+                    }
+                }
+                if (!collision) break;
+            }
+#endif
+        }
+    }
+
+    uint64_t attacks(int sq, uint64_t occupied) const {
+        return table[offsets[sq] + index(sq, occupied)];
+    }
+};
+
+const MagicTable& tableFor(SliderKind kind, int range) {
+    static std::unique_ptr<MagicTable> tables[2][FULL_RANGE + 1];
+    static std::once_flag built[2][FULL_RANGE + 1];
+    std::call_once(built[kind][range], [kind, range] {
+        tables[kind][range] = std::make_unique<MagicTable>(kind, range);
+    });
+    return *tables[kind][range];
+}
+
+}
+
+void sliders::init(const GameConfig& config) {
+    if (config.game_settings.board_size != 8) return;
+    // Direct slides always run to the edge: a configured range limits the
+    // chained steps of the reach search, which already cover every square
+    // a bounded slide would. So only the unlimited tables are ever read.
+    tableFor(ORTHOGONAL, FULL_RANGE);
+    tableFor(DIAGONAL, FULL_RANGE);
+}
+
+uint64_t sliders::magicAttacks(SliderKind kind, int sq, uint64_t occupied, int range) {
+    if (range <= 0) return 0;
+    return tableFor(kind, std::min(range, FULL_RANGE)).attacks(sq, occupied);
+}
@@ -0,0 +1,57 @@
+#pragma once
+#include <cstdint>
+#include "BitboardPosition.h"
+
+struct GameConfig;
+
+enum SliderKind { ORTHOGONAL = 0, DIAGONAL = 1 };
+
+// Attack sets for rook-like (orthogonal) and bishop-like (diagonal)
+// sliders. A slider reaches every square along its rays up to `range`
+// steps, stopping at and including the first occupied square. On 8x8
+// boards the set is one magic-indexed (or PEXT-indexed, when built with
+// BMI2) table lookup per direction class; other sizes scan the
+// precomputed rays for the nearest blocker.
+namespace sliders {
+
+// Range meaning "to the edge of the board".
+constexpr int UNLIMITED = 1 << 16;
+
+// Builds the unlimited 8x8 tables that direct slides use. Tables for a
+// bounded range are built on first use.
+void init(const GameConfig& config);
+
+uint64_t magicAttacks(SliderKind kind, int sq, uint64_t occupied, int range);
+
+inline bool isPositive(int dir) { return dir == 0 || dir == 2 || dir == 4 || dir == 5; }
+
+template <typename Set>
+Set rayAttacks(const BitboardGeometry<Set>& geometry, int sq, SliderKind kind, int range, const Set& occupied) {
+    Set result;
+    if (range <= 0) return result;
+    int first = kind == ORTHOGONAL ? 0 : 4;
+    for (int dir = first; dir < first + 4; ++dir) {
+        Set ray = range >= geometry.size ? geometry.ray(sq, dir) : geometry.clippedRay(sq, dir, range);
+        Set blockers = ray & occupied;
+        if (blockers.any()) {
+            int blocker = isPositive(dir) ? blockers.lsb() : blockers.msb();
+            ray &= ~geometry.ray(blocker, dir);
+        }
+        result |= ray;
+    }
+    return result;
+}
+
+template <typename Set>
+Set attacks(const BitboardPosition<Set>& pos, int sq, SliderKind kind, int range, const Set& occupied) {
+    if constexpr (Set::BITS == 64) {
+        if (pos.size() == 8) {
+            Set result;
+            result.words[0] = magicAttacks(kind, sq, occupied.words[0], range);
+            return result;
+        }
+    }
+    return rayAttacks(*pos.geometry, sq, kind, range, occupied);
+}
+
+}
@@ -0,0 +1,181 @@
+#include "TranspositionTable.h"
+
+namespace {
+constexpr int CHECK_KNOWN = 0;
+constexpr int IN_CHECK = 2;
+constexpr int MATE_KNOWN = 4;
+constexpr int IS_MATE = 6;
+
+uint32_t verificationKey(uint64_t key) { return static_cast<uint32_t>(key >> 32); }
+
+uint64_t packData(const TTEntry& entry) {
+    return static_cast<uint64_t>(entry.from) | static_cast<uint64_t>(entry.to) << 16 |
+           static_cast<uint64_t>(entry.moveFlags) << 32 | static_cast<uint64_t>(entry.promotion) << 40 |
+           static_cast<uint64_t>(static_cast<uint16_t>(entry.score)) << 48;
+}
+
+// Depth is stored off by one so that a zeroed slot reads as empty.
+uint64_t packMeta(const TTEntry& entry) {
+    return static_cast<uint64_t>(entry.key) << 32 | static_cast<uint64_t>(static_cast<uint8_t>(entry.depth + 1)) << 24 |
+           static_cast<uint64_t>(entry.generationBound) << 16 | static_cast<uint64_t>(entry.status) << 8;
+}
+}
+
+static_assert(sizeof(TTEntry) == 16, "four entries must fill one cache line");
+
+TranspositionTable::TranspositionTable(size_t megabytes) {
+    resize(megabytes);
+}
+
+void TranspositionTable::resize(size_t megabytes) {
+    size_t count = (megabytes ? megabytes : 1) * 1024 * 1024 / sizeof(Bucket);
+    size_t powerOfTwo = 1;
+    while (powerOfTwo * 2 <= count) powerOfTwo *= 2;
+    buckets.reset(new Bucket[powerOfTwo]);
+    bucketCount = powerOfTwo;
+    mask = powerOfTwo - 1;
+    generation = 0;
+}
+
+void TranspositionTable::clear() {
+    for (size_t i = 0; i < bucketCount; ++i) {
+        for (Slot& slot : buckets[i].slots) {
+            slot.check.store(0, std::memory_order_relaxed);
+            slot.data.store(0, std::memory_order_relaxed);
+        }
+    }
+    generation = 0;
+}
+
+size_t TranspositionTable::getMegabytes() const {
+    return bucketCount * sizeof(Bucket) / (1024 * 1024);
+}
+
+TTEntry TranspositionTable::read(const Slot& slot) {
+    uint64_t data = slot.data.load(std::memory_order_relaxed);
+    uint64_t meta = slot.check.load(std::memory_order_relaxed) ^ data;
+    TTEntry entry;
+    entry.key = static_cast<uint32_t>(meta >> 32);
+    entry.depth = static_cast<int8_t>(static_cast<uint8_t>(meta >> 24) - 1);
+    entry.generationBound = static_cast<uint8_t>(meta >> 16);
+    entry.status = static_cast<uint8_t>(meta >> 8);
+    entry.from = static_cast<uint16_t>(data);
+    entry.to = static_cast<uint16_t>(data >> 16);
+    entry.moveFlags = static_cast<uint8_t>(data >> 32);
+    entry.promotion = static_cast<uint8_t>(data >> 40);
+    entry.score = static_cast<int16_t>(data >> 48);
+    return entry;
+}
+
+void TranspositionTable::write(Slot& slot, const TTEntry& entry) {
+    uint64_t data = packData(entry);
+    slot.data.store(data, std::memory_order_relaxed);
+    slot.check.store(packMeta(entry) ^ data, std::memory_order_relaxed);
+}
+
+bool TranspositionTable::find(uint64_t key, TTEntry& entry) const {
+    const Bucket& bucket = bucketFor(key);
+    uint32_t check = verificationKey(key);
+    for (const Slot& slot : bucket.slots) {
+        TTEntry candidate = read(slot);
+        if (candidate.key == check && (candidate.depth != TTEntry::DEPTH_NONE || candidate.status)) {
+            entry = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+// The slot holding this position, or the least valuable slot in its
+// bucket; `entry` receives its current contents, or a fresh entry for the
+// position when the slot is being taken over.
+TranspositionTable::Slot& TranspositionTable::slotFor(uint64_t key, TTEntry& entry) {
+    Bucket& bucket = bucketFor(key);
+    uint32_t check = verificationKey(key);
+    Slot* victim = &bucket.slots[0];
+    int victimWorth = 1 << 30;
+    for (Slot& slot : bucket.slots) {
+        TTEntry candidate = read(slot);
+        if (candidate.key == check) {
+            entry = candidate;
+            return slot;
+        }
+        int age = (generation - candidate.generation()) & 63;
+        int worth = candidate.depth - 8 * age;
+        if (worth < victimWorth) {
+            victim = &slot;
+            victimWorth = worth;
+        }
+    }
+    entry = TTEntry();
+    entry.key = check;
+    entry.generationBound = static_cast<uint8_t>(generation << 2);
+    return *victim;
+}
+
+bool TranspositionTable::probe(uint64_t key, TTEntry& entry) const {
+    return find(key, entry) && entry.depth != TTEntry::DEPTH_NONE;
+}
+
+void TranspositionTable::store(uint64_t key, int depth, Bound bound, int score, const Move& best) {
+    TTEntry entry;
+    Slot& slot = slotFor(key, entry);
+    // Keep a deeper result from this search unless the new one is exact.
+    if (entry.depth > depth && entry.generation() == generation && bound != BOUND_EXACT) return;
+    if (best.from != best.to || entry.depth == TTEntry::DEPTH_NONE) {
+        entry.from = best.from;
+        entry.to = best.to;
+        entry.moveFlags = best.flags;
+        entry.promotion = best.promotion;
+    }
+    entry.score = static_cast<int16_t>(score);
+    entry.depth = static_cast<int8_t>(depth);
+    entry.generationBound = static_cast<uint8_t>(generation << 2 | bound);
+    write(slot, entry);
+}
+
+bool TranspositionTable::probeStatus(uint64_t key, int knownBit, int valueBit, bool& value) const {
+    TTEntry entry;
+    if (!find(key, entry) || !(entry.status & (1 << knownBit))) return false;
+    value = (entry.status & (1 << valueBit)) != 0;
+    return true;
+}
+
+void TranspositionTable::storeStatus(uint64_t key, int knownBit, int valueBit, bool value) {
+    TTEntry entry;
+    Slot& slot = slotFor(key, entry);
+    entry.status |= 1 << knownBit;
+    if (value) entry.status |= 1 << valueBit;
+    else entry.status &= ~(1 << valueBit);
+    write(slot, entry);
+}
+
+bool TranspositionTable::probeCheck(uint64_t key, int color, bool& inCheck) const {
+    return probeStatus(key, CHECK_KNOWN + color, IN_CHECK + color, inCheck);
+}
+
+void TranspositionTable::storeCheck(uint64_t key, int color, bool inCheck) {
+    storeStatus(key, CHECK_KNOWN + color, IN_CHECK + color, inCheck);
+}
+
+bool TranspositionTable::probeCheckmate(uint64_t key, int color, bool& checkmate) const {
+    return probeStatus(key, MATE_KNOWN + color, IS_MATE + color, checkmate);
+}
+
+void TranspositionTable::storeCheckmate(uint64_t key, int color, bool checkmate) {
+    storeStatus(key, MATE_KNOWN + color, IS_MATE + color, checkmate);
+}
+
+int TranspositionTable::hashfull() const {
+    int used = 0;
+    int sampled = 0;
+    for (size_t i = 0; i < bucketCount && sampled < 1000; ++i) {
+        for (const Slot& slot : buckets[i].slots) {
+            if (sampled == 1000) break;
+            ++sampled;
+            TTEntry entry = read(slot);
+            if (entry.depth != TTEntry::DEPTH_NONE && entry.generation() == generation) ++used;
+        }
+    }
+    return sampled ? used * 1000 / sampled : 0;
+}
@@ -0,0 +1,97 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include "Move.h"
+
+enum Bound : uint8_t {
+    BOUND_NONE = 0,
+    BOUND_UPPER = 1,
+    BOUND_LOWER = 2,
+    BOUND_EXACT = 3
+};
+
+// The contents of one slot. Besides search results (depth, bound, score,
+// best move) a slot remembers the check and checkmate status of each color
+// in its position, so those scans run once per position rather than once
+// per visit.
+struct TTEntry {
+    static constexpr int DEPTH_NONE = -1;
+
+    uint32_t key = 0;  // upper half of the position key
+    uint16_t from = 0;
+    uint16_t to = 0;
+    uint8_t moveFlags = 0;
+    uint8_t promotion = 0;
+    int16_t score = 0;
+    int8_t depth = DEPTH_NONE;
+    uint8_t generationBound = 0;  // generation << 2 | bound
+    uint8_t status = 0;
+
+    Bound bound() const { return static_cast<Bound>(generationBound & 3); }
+    uint8_t generation() const { return generationBound >> 2; }
+    Move move() const { return {from, to, moveFlags, promotion}; }
+};
+
+// Fixed-size hash table of search results. Entries are grouped four to a
+// 64-byte bucket so a probe touches a single cache line. A store replaces
+// the slot already holding the position, else the slot that is shallowest
+// after penalizing entries left over from earlier searches.
+//
+// The table is shared by all search threads without locks. A slot is two
+// 64-bit words, the packed data and the packed key and metadata XORed with
+// that data; a reader that sees the words of two different writes decodes
+// a key that does not match and treats the slot as a miss.
+class TranspositionTable {
+public:
+    static constexpr size_t DEFAULT_MEGABYTES = 16;
+
+    explicit TranspositionTable(size_t megabytes = DEFAULT_MEGABYTES);
+
+    // Not safe while a search is running.
+    void resize(size_t megabytes);
+    void clear();
+
+    // Starts a new search; entries from older searches become preferred
+    // replacement victims.
+    void newSearch() { generation = (generation + 1) & 63; }
+
+    bool probe(uint64_t key, TTEntry& entry) const;
+    void store(uint64_t key, int depth, Bound bound, int score, const Move& best);
+
+    bool probeCheck(uint64_t key, int color, bool& inCheck) const;
+    void storeCheck(uint64_t key, int color, bool inCheck);
+    bool probeCheckmate(uint64_t key, int color, bool& checkmate) const;
+    void storeCheckmate(uint64_t key, int color, bool checkmate);
+
+    size_t getMegabytes() const;
+
+    // Permille of sampled slots written during the current search.
+    int hashfull() const;
+
+private:
+    static constexpr int BUCKET_SIZE = 4;
+
+    struct Slot {
+        std::atomic<uint64_t> check{0};
+        std::atomic<uint64_t> data{0};
+    };
+
+    struct alignas(64) Bucket {
+        Slot slots[BUCKET_SIZE];
+    };
+
+    std::unique_ptr<Bucket[]> buckets;
+    size_t bucketCount = 0;
+    uint64_t mask = 0;
+    uint8_t generation = 0;
+
+    Bucket& bucketFor(uint64_t key) const { return buckets[key & mask]; }
+    static TTEntry read(const Slot& slot);
+    static void write(Slot& slot, const TTEntry& entry);
+    bool find(uint64_t key, TTEntry& entry) const;
+    Slot& slotFor(uint64_t key, TTEntry& entry);
+    bool probeStatus(uint64_t key, int knownBit, int valueBit, bool& value) const;
+    void storeStatus(uint64_t key, int knownBit, int valueBit, bool value);
+};
@@ -0,0 +1,85 @@
+#include "ValidatorStress.h"
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "MoveGenerator.h"
+#include "MoveValidator.h"
+
+namespace {
+struct Workload {
+    std::vector<std::unique_ptr<GameState>> positions;
+    std::vector<MoveValidator> validators;
+};
+
+// Answers of every query folded into one value, plus how many were asked.
+struct Answers {
+    uint64_t digest = 0;
+    uint64_t queries = 0;
+};
+
+Answers ask(const Workload& work) {
+    Answers answers;
+    auto fold = [&](bool answer) {
+        answers.digest = answers.digest * 1099511628211ULL + (answer ? 2 : 1);
+        ++answers.queries;
+    };
+    for (size_t i = 0; i < work.positions.size(); ++i) {
+        const GameState& position = *work.positions[i];
+        const MoveValidator& validator = work.validators[i];
+        int size = position.board.getSize();
+        for (int color = WHITE; color <= BLACK; ++color) {
+            position.board.forEachPiece(color, [&](const Piece* piece, int x, int y) {
+                for (int toY = 0; toY < size; ++toY) {
+                    for (int toX = 0; toX < size; ++toX) {
+                        fold(validator.validateMove(piece, x, y, toX, toY, position.portals));
+                    }
+                }
+            });
+            fold(validator.isCheckmate(color, position.portals));
+        }
+    }
+    return answers;
+}
+}
+
+bool stressValidator(const GameState& state, int maxThreads, std::ostream& out) {
+    Workload work;
+    work.positions.push_back(std::make_unique<GameState>(state));
+    MoveList moves;
+    if (!state.isGameOver()) MoveGenerator(state).generatePseudoLegalMoves(state.sideToMove, moves);
+    for (const Move& move : moves) {
+        work.positions.push_back(std::make_unique<GameState>(state));
+        work.positions.back()->applyMove(move);
+    }
+    // Built once the positions are in place: validators point into them.
+    for (const auto& position : work.positions) work.validators.emplace_back(*position);
+
+    Answers reference = ask(work);
+    out << "Positions: " << work.positions.size() << ", queries per pass: " << reference.queries << "\n";
+
+    bool consistent = true;
+    double baseRate = 0.0;
+    for (int threads = 1; threads <= maxThreads; threads *= 2) {
+        std::vector<Answers> results(threads);
+        std::vector<std::thread> pool;
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < threads; ++i) {
+            pool.emplace_back([&work, &results, i] { results[i] = ask(work); });
+        }
+        for (std::thread& thread : pool) thread.join();
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        for (const Answers& result : results) {
+            if (result.digest != reference.digest || result.queries != reference.queries) consistent = false;
+        }
+        double rate = seconds > 0.0 ? reference.queries * threads / seconds : 0.0;
+        if (threads == 1) baseRate = rate;
+        out << "Threads: " << threads << "  queries/s: " << static_cast<int64_t>(rate)
+            << "  speedup: " << (baseRate > 0.0 ? rate / baseRate : 0.0) << "\n";
+    }
+    out << (consistent ? "All threads agree with the single-threaded answers\n"
+                       : "MISMATCH: threads disagree with the single-threaded answers\n");
+    return consistent;
+}
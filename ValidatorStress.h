@@ -0,0 +1,11 @@
+#pragma once
+#include <ostream>
+#include "GameState.h"
+
+// Checks that MoveValidator queries are safe to run concurrently: one
+// validator per position (the state and every position a pseudo-legal move
+// away) is shared by 1, 2, 4, ... up to maxThreads threads, each asking
+// validateMove for every piece and square and isCheckmate for both sides.
+// Prints the query rate and speedup for each thread count and returns
+// false if any thread's answers differ from a single-threaded run.
+bool stressValidator(const GameState& state, int maxThreads, std::ostream& out);
@@ -0,0 +1,65 @@
+#include "Zobrist.h"
+#include <algorithm>
+#include "ConfigReader.hpp"
+#include "Piece.h"
+
+namespace zobrist {
+
+namespace detail {
+std::vector<uint64_t> pieceKeys;
+int typeCount = 0;
+int squareCount = 0;
+}
+
+namespace {
+enum KeyKind : uint64_t { PIECE = 1, SIDE, EN_PASSANT, PORTAL };
+
+// splitmix64 finalizer over a packed (kind, a, b, c) tuple.
+uint64_t mix(KeyKind kind, uint64_t a, uint64_t b, uint64_t c) {
+    uint64_t z = (static_cast<uint64_t>(kind) << 48) ^ ((a & 0xFFFF) << 32) ^ ((b & 0xFFFF) << 16) ^ (c & 0xFFFF);
+    z += 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+}
+
+void init(const GameConfig& config) {
+    int types = 0;
+    for (const auto* group : {&config.pieces, &config.custom_pieces}) {
+        for (const auto& pieceCfg : *group) {
+            types = std::max(types, Piece::typeIdOf(pieceCfg.type) + 1);
+        }
+    }
+    int squares = config.game_settings.board_size * config.game_settings.board_size;
+
+    std::vector<uint64_t> keys(static_cast<size_t>(types) * 2 * squares);
+    for (int type = 0; type < types; ++type) {
+        for (int color = 0; color < 2; ++color) {
+            for (int sq = 0; sq < squares; ++sq) {
+                keys[(type * 2 + color) * squares + sq] = computePieceKey(type, color, sq);
+            }
+        }
+    }
+    detail::pieceKeys = std::move(keys);
+    detail::typeCount = types;
+    detail::squareCount = squares;
+}
+
+uint64_t computePieceKey(int typeId, int colorId, int square) {
+    return mix(PIECE, typeId, colorId, square);
+}
+
+uint64_t sideKey() {
+    return mix(SIDE, 0, 0, 0);
+}
+
+uint64_t enPassantKey(int file) {
+    return mix(EN_PASSANT, file, 0, 0);
+}
+
+uint64_t portalKey(int portalIndex, int cooldown) {
+    return cooldown > 0 ? mix(PORTAL, portalIndex, cooldown, 0) : 0;
+}
+
+}
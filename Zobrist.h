@@ -0,0 +1,41 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+struct GameConfig;
+
+// 64-bit Zobrist keys for position hashing. Each key is a fixed function
+// of what it describes, so keys agree between boards, threads and runs;
+// init() only precomputes the piece keys for the config's types and board
+// size, which keeps the incremental updates in ChessBoard to a lookup.
+// Squares are numbered y * boardSize + x.
+namespace zobrist {
+
+void init(const GameConfig& config);
+
+uint64_t computePieceKey(int typeId, int colorId, int square);
+
+namespace detail {
+extern std::vector<uint64_t> pieceKeys;
+extern int typeCount;
+extern int squareCount;
+}
+
+inline uint64_t pieceKey(int typeId, int colorId, int square) {
+    if (typeId < detail::typeCount && colorId < 2 && square < detail::squareCount) {
+        return detail::pieceKeys[(typeId * 2 + colorId) * detail::squareCount + square];
+    }
+    return computePieceKey(typeId, colorId, square);
+}
+
+// Black to move.
+uint64_t sideKey();
+
+// The pawn on this file may be taken en passant.
+uint64_t enPassantKey(int file);
+
+// Portal number `portalIndex` has `cooldown` turns left; an open portal
+// contributes nothing.
+uint64_t portalKey(int portalIndex, int cooldown);
+
+}
@@ -1,22 +1,23 @@
+#include <cstdlib>
 #include <iostream>
-#include <stack>
+#include <sstream>
 #include "ChessBoard.h"
 #include "MoveValidator.h"
 #include "Piece.h"
 #include "ConfigReader.hpp"
 #include "Position.h"
 #include "BoardPrinter.h"
-
-struct MoveRecord {
-    int fromX, fromY, toX, toY;
-    std::string pieceType;
-    std::string pieceColor;
-    Piece* capturedPiece = nullptr;
-    bool usedPortal = false;
-    Position portalExit;
-};
-
-int main() {
+#include "ReachTables.h"
+#include "SliderAttacks.h"
+#include "Zobrist.h"
+#include "GameSetup.h"
+#include "MoveGenerator.h"
+#include "Perft.h"
+#include "Evaluation.h"
+#include "Search.h"
+#include "TranspositionTable.h"
+
+int main(int argc, char* argv[]) {
     ConfigReader reader;
 
     if (!reader.loadFromFile("chess_pieces.json")) {
@@ -25,117 +26,47 @@ int main() {
     }
 
     const GameConfig& config = reader.getConfig();
-    ChessBoard* board = new ChessBoard(config.game_settings.board_size);
-    std::vector<Portal> portals;
-    for (const auto& pc : reader.getPortals()) {
-        portals.emplace_back(
-            pc.id,
-            pc.positions.entry,
-            pc.positions.exit,
-            pc.properties.preserve_direction,
-            pc.properties.allowed_colors,
-            pc.properties.cooldown
-        );
-    }
-
-    for (const auto& pieceCfg : config.pieces) {
-        for (const auto& [color, positions] : pieceCfg.positions) {
-            for (const auto& pos : positions) {
-                std::map<std::string, int> movementMap;
-                if (pieceCfg.movement.forward > 0)
-                    movementMap["forward"] = pieceCfg.movement.forward;
-                if (pieceCfg.movement.sideways > 0)
-                    movementMap["sideways"] = pieceCfg.movement.sideways;
-                if (pieceCfg.movement.diagonal > 0)
-                    movementMap["diagonal"] = pieceCfg.movement.diagonal;
-                if (pieceCfg.movement.l_shape)
-                    movementMap["l_shape"] = 1;
-
-                std::map<std::string, bool> abilities(pieceCfg.special_abilities.custom_abilities.begin(),
-                                                     pieceCfg.special_abilities.custom_abilities.end());
-                abilities["castling"] = pieceCfg.special_abilities.castling;
-                abilities["royal"] = pieceCfg.special_abilities.royal;
-                abilities["jump_over"] = pieceCfg.special_abilities.jump_over;
-                abilities["promotion"] = pieceCfg.special_abilities.promotion;
-                abilities["en_passant"] = pieceCfg.special_abilities.en_passant;
-
-                Piece* piece = new Piece(
-                    std::string(pieceCfg.type),
-                    std::string(color),
-                    movementMap,
-                    abilities
-                );
-
-                board->placePiece(pos.x, pos.y, piece);
-            }
-        }
+    sliders::init(config);
+    reach::init(config);
+    zobrist::init(config);
+    eval::init(config);
+
+    int hashMegabytes = config.game_settings.hash_size_mb;
+    int threads = 1;
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (std::string(argv[i]) == "--hash") hashMegabytes = std::atoi(argv[i + 1]);
+        else if (std::string(argv[i]) == "--threads") threads = std::atoi(argv[i + 1]);
     }
+    TranspositionTable table(hashMegabytes);
+    Search search(table, threads);
+    GameState game = createGameState(config);
+    game.trackAttacks();
+    ChessBoard* board = &game.board;
+    std::vector<Portal>& portals = game.portals;
 
-    // Custom pieces'i de tahtaya yerleştir
-    for (const auto& pieceCfg : config.custom_pieces) {
-        for (const auto& [color, positions] : pieceCfg.positions) {
-            for (const auto& pos : positions) {
-                std::map<std::string, int> movementMap;
-                if (pieceCfg.movement.forward > 0)
-                    movementMap["forward"] = pieceCfg.movement.forward;
-                if (pieceCfg.movement.sideways > 0)
-                    movementMap["sideways"] = pieceCfg.movement.sideways;
-                if (pieceCfg.movement.diagonal > 0)
-                    movementMap["diagonal"] = pieceCfg.movement.diagonal;
-                if (pieceCfg.movement.l_shape)
-                    movementMap["l_shape"] = 1;
-
-                std::map<std::string, bool> abilities(pieceCfg.special_abilities.custom_abilities.begin(),
-                                                     pieceCfg.special_abilities.custom_abilities.end());
-                abilities["castling"] = pieceCfg.special_abilities.castling;
-                abilities["royal"] = pieceCfg.special_abilities.royal;
-                abilities["jump_over"] = pieceCfg.special_abilities.jump_over;
-                abilities["promotion"] = pieceCfg.special_abilities.promotion;
-                abilities["en_passant"] = pieceCfg.special_abilities.en_passant;
-
-                Piece* piece = new Piece(
-                    std::string(pieceCfg.type),
-                    std::string(color),
-                    movementMap,
-                    abilities
-                );
-
-                board->placePiece(pos.x, pos.y, piece);
-            }
-        }
-    }
-
-    MoveValidator validator(board);
-    std::stack<MoveRecord> moveHistory;
     BoardPrinter printer;
-    std::cout << "\nCustom Chess started. Commands: move x1 y1 x2 y2 | undo | quit\n\n";
+    std::cout << "\nCustom Chess started. Commands: move x1 y1 x2 y2 | undo | perft depth | "
+                 "engine go depth N | engine go movetime MS | engine threads N | attacks white|black | quit\n\n";
 
+    // The REPL does not enforce turns: every move is made as the mover's
+    // color, so the side to move is always the opponent of whoever moved
+    // last.
     std::string command;
     while (true) {
         printer.print(*board);
         std::cout << "> ";
         std::cin >> command;
+        MoveValidator validator(board, &game.getPortalMap(), game.turn);
 
         if (command == "quit" || command == "exit") {
             std::cout << "Game ended.\n";
             break;
         } else if (command == "undo") {
-            if (moveHistory.empty()) {
+            if (game.historySize() == 0) {
                 std::cout << "No move to undo!\n";
                 continue;
             }
-            MoveRecord last = moveHistory.top();
-            moveHistory.pop();
-
-            Piece* piece = board->getPieceAt(last.toX, last.toY);
-            if (last.usedPortal) {
-                board->movePiece(last.portalExit.x, last.portalExit.y, last.fromX, last.fromY);
-            } else {
-                board->movePiece(last.toX, last.toY, last.fromX, last.fromY);
-            }
-            if (last.capturedPiece) {
-                board->placePiece(last.toX, last.toY, last.capturedPiece);
-            }
+            game.unmakeMove();
             std::cout << "Last move undone!\n";
             continue;
         } else if (command == "move") {
@@ -149,35 +80,64 @@ int main() {
             }
 
             if (validator.validateMove(piece, x1, y1, x2, y2, portals)) {
-                Piece* captured = board->getPieceAt(x2, y2);
-                board->movePiece(x1, y1, x2, y2);
+                Move move = MoveGenerator(game).moveFor(piece, x1, y1, x2, y2, false);
+                const Portal* portal = game.portalAt(x2, y2, piece->getColorId());
+                game.sideToMove = piece->getColorId();
+                game.makeMove(move);
                 std::cout << piece->getType() << " moved!\n";
 
-                bool usedPortal = false;
-                Position portalExit;
-                for (auto& portal : portals) {
-                    Position entry = portal.getEntry();
-                    Position exit = portal.getExit();
-                    if (entry.x == x2 && entry.y == y2 && portal.isColorAllowed(piece->getColor())) {
-                        if (portal.isAvailable()) {
-                            std::cout << "Portal active: " << portal.getId() << " → piece is teleporting...\n";
-                            board->movePiece(x2, y2, exit.x, exit.y);
-                            std::cout << piece->getType() << " teleported via portal (" << x2 << "," << y2 << ") → ("
-                                      << exit.x << "," << exit.y << ")\n";
-                            portal.startCooldown();
-                            usedPortal = true;
-                            portalExit = exit;
-                        } else {
-                            std::cout << "Portal is on cooldown: " << portal.getId() << "\n";
-                        }
-                        break;
-                    }
+                if (portal && move.is(MOVE_PORTAL)) {
+                    Position exit = portal->getExit();
+                    std::cout << "Portal active: " << portal->getId() << " → piece is teleporting...\n";
+                    std::cout << piece->getType() << " teleported via portal (" << x2 << "," << y2 << ") → ("
+                              << exit.x << "," << exit.y << ")\n";
+                } else if (portal) {
+                    std::cout << "Portal is on cooldown: " << portal->getId() << "\n";
                 }
-
-                moveHistory.push({x1, y1, x2, y2, piece->getType(), piece->getColor(), captured, usedPortal, portalExit});
             } else {
                 std::cout << "Invalid move!\n";
             }
+        } else if (command == "perft") {
+            int depth;
+            std::cin >> depth;
+            perftDivide(game, depth, PerftMode::PSEUDO_LEGAL, std::cout);
+            continue;
+        } else if (command == "engine") {
+            std::string line, go, limit;
+            int value = 0;
+            std::getline(std::cin, line);
+            std::istringstream(line) >> go >> limit >> value;
+            SearchLimits limits;
+            if (go == "threads" && !limit.empty()) {
+                search.setThreads(std::atoi(limit.c_str()));
+                std::cout << "Search threads: " << search.getThreads() << "\n";
+                continue;
+            } else if (go == "go" && limit == "depth") {
+                limits.depth = value;
+            } else if (go == "go" && limit == "movetime") {
+                limits.movetimeMs = value;
+            } else {
+                std::cout << "Usage: engine go depth N | engine go movetime MS | engine threads N\n";
+                continue;
+            }
+            SearchResult result = search.run(game, limits, &std::cout);
+            if (result.hasMove)
+                std::cout << "bestmove " << moveToString(result.bestMove, board->getSize()) << "\n";
+            else
+                std::cout << "No move available!\n";
+            continue;
+        } else if (command == "attacks") {
+            std::string colorArg;
+            std::cin >> colorArg;
+            int color = Piece::colorIdOf(colorArg);
+            if (color != WHITE && color != BLACK) {
+                std::cout << "Usage: attacks white|black\n";
+                continue;
+            }
+            printer.printAttacks(*board, *game.getAttackMap(), color);
+            int enemy = opponentOf(color);
+            std::cout << colorName(enemy) << " king " << (game.isInCheck(enemy) ? "is" : "is not") << " in check\n";
+            continue;
         } else if (command == "attack") {
             int x1, y1, x2, y2;
             std::cin >> x1 >> y1 >> x2 >> y2;
@@ -186,36 +146,18 @@ int main() {
                 std::cout << "No piece at that position!\n";
                 continue;
             }
-            if (!piece->hasAbility("ranged_attack")) {
-                std::cout << "This piece does not have the ranged_attack ability!\n";
-                continue;
-            }
-            int range = 1;
-            auto movement = piece->getMovement();
-            if (movement.find("attack_range") != movement.end())
-                range = movement["attack_range"];
-            int dx = abs(x2 - x1);
-            int dy = abs(y2 - y1);
-            if ((dx <= range && dy == 0) || (dy <= range && dx == 0) || (dx == dy && dx <= range)) {
-                Piece* target = board->getPieceAt(x2, y2);
-                if (target && target->getColor() != piece->getColor()) {
-                    board->removePiece(x2, y2);
-                    std::cout << piece->getType() << " performed a ranged attack and destroyed the enemy piece!\n";
-                } else {
-                    std::cout << "No enemy piece at the target!\n";
-                }
+            if (validator.canShoot(piece, x1, y1, x2, y2)) {
+                game.sideToMove = piece->getColorId();
+                game.makeMove(MoveGenerator(game).moveFor(piece, x1, y1, x2, y2, true));
+                std::cout << piece->getType() << " performed a ranged attack and destroyed the enemy piece!\n";
             } else {
-                std::cout << "Target is out of range!\n";
+                std::cout << "This piece cannot attack that square!\n";
             }
             continue;
         } else {
             std::cout << "Unknown command!\n";
         }
 
-        for (auto& portal : portals) {
-            portal.decrementCooldown();
-        }
-
         if (validator.isGameOver(portals)) {
             if (validator.getWinner(portals) == "white")
                 std::cout << "White wins!\n";
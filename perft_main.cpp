@@ -0,0 +1,50 @@
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include "ConfigReader.hpp"
+#include "GameSetup.h"
+#include "Perft.h"
+#include "ReachTables.h"
+#include "SliderAttacks.h"
+#include "TranspositionTable.h"
+#include "ValidatorStress.h"
+#include "Zobrist.h"
+
+int main(int argc, char* argv[]) {
+    int depth = -1;
+    std::string configPath = "chess_pieces.json";
+    PerftMode mode = PerftMode::PSEUDO_LEGAL;
+    int hashMegabytes = -1;
+    int stressThreads = 0;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--legal") == 0) mode = PerftMode::LEGAL;
+        else if (std::strcmp(argv[i], "--hash") == 0 && i + 1 < argc) hashMegabytes = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--stress-validator") == 0 && i + 1 < argc) stressThreads = std::atoi(argv[++i]);
+        else if (depth < 0 && std::isdigit(static_cast<unsigned char>(argv[i][0]))) depth = std::atoi(argv[i]);
+        else configPath = argv[i];
+    }
+    if (depth < 0 && stressThreads <= 0) {
+        std::cerr << "Usage: chess3_perft <depth> [config.json] [--legal] [--hash MB]\n"
+                  << "       chess3_perft --stress-validator <threads> [config.json]\n";
+        return 1;
+    }
+
+    ConfigReader reader;
+    if (!reader.loadFromFile(configPath)) {
+        std::cerr << "Failed to load " << configPath << "\n";
+        return 1;
+    }
+    const GameConfig& config = reader.getConfig();
+    sliders::init(config);
+    reach::init(config);
+    zobrist::init(config);
+
+    TranspositionTable table(hashMegabytes >= 0 ? hashMegabytes : config.game_settings.hash_size_mb);
+    GameState state = createGameState(config);
+    state.setTranspositionTable(&table);
+    if (stressThreads > 0) return stressValidator(state, stressThreads, std::cout) ? 0 : 1;
+    perftDivide(state, depth, mode, std::cout);
+    return 0;
+}